@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Ids of the activity timeouts in the settings registry
+#define ZMK_SETTING_ID_IDLE_MS  1
+#define ZMK_SETTING_ID_SLEEP_MS 2
+
+/**
+ * Check a pair of activity timeouts. A timeout of 0 disables it; if both are
+ * enabled, the sleep timeout must not be shorter than the idle timeout.
+ */
+bool zmk_activity_settings_valid(uint32_t idle_ms, uint32_t sleep_ms);
+
+/*
+ * Every device either inherits the activity timeouts of the central, which is
+ * the default, or has its own. The central's timeouts are relayed to all
+ * peripherals, and those with their own timeouts keep them, so a peripheral
+ * with a smaller battery can go to sleep sooner than the central.
+ */
+
+/**
+ * Apply activity timeouts on this device only, without relaying them.
+ *
+ * The pair is validated up front and applied as a whole: if either timeout
+ * is rejected, neither is changed. The values take effect immediately. With
+ * CONFIG_ZMK_SETTINGS_RPC_PERSIST, they are written as one settings record
+ * once no further change arrived for CONFIG_ZMK_SETTINGS_RPC_SAVE_DEBOUNCE_MS,
+ * or before the keyboard goes to sleep, whichever comes first.
+ *
+ * Use it to apply settings received from another device. Local changes
+ * should go through zmk_activity_set_timeouts().
+ *
+ * @return 0 on success, -EINVAL if the pair is invalid or was rejected
+ */
+int zmk_activity_settings_apply(uint32_t idle_ms, uint32_t sleep_ms);
+
+/**
+ * Apply activity timeouts as with zmk_activity_settings_apply() and, with
+ * CONFIG_ZMK_SPLIT_RELAY_EVENT, raise a single zmk_activity_settings_changed
+ * to propagate them to the peripherals that inherit them. Nothing is relayed
+ * if the timeouts in effect are applied again.
+ *
+ * @return 0 on success, -EINVAL if the pair is invalid or was rejected
+ */
+int zmk_activity_set_timeouts(uint32_t idle_ms, uint32_t sleep_ms);
+
+/**
+ * Apply activity timeouts on some devices only: as the central's timeouts
+ * with zmk_activity_set_timeouts() if @p local is set, and as their own
+ * timeouts on the peripherals in @p dest, a ZMK_SETTINGS_RELAY_DEST()
+ * bitmask (0 for none). The pair is validated even if it is only relayed.
+ *
+ * @return 0 on success, -EINVAL if the pair is invalid or was rejected
+ */
+int zmk_activity_set_timeouts_on(uint32_t idle_ms, uint32_t sleep_ms,
+                                 bool local, uint8_t dest);
+
+/**
+ * Make the peripherals in @p dest, a ZMK_SETTINGS_RELAY_DEST() bitmask, drop
+ * their own activity timeouts and inherit the central's again.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+int zmk_activity_settings_inherit_on(uint8_t dest);
+
+/**
+ * Apply the central's activity timeouts received on a peripheral. They take
+ * effect unless this device has its own, and are kept to fall back to
+ * otherwise.
+ *
+ * @return 0 on success, -EINVAL if the pair is invalid or was rejected
+ */
+int zmk_activity_settings_apply_inherited(uint32_t idle_ms, uint32_t sleep_ms);
+
+/**
+ * Apply activity timeouts of this device's own, which take precedence over
+ * the central's until zmk_activity_settings_drop_own() is called.
+ *
+ * @return 0 on success, -EINVAL if the pair is invalid or was rejected
+ */
+int zmk_activity_settings_apply_own(uint32_t idle_ms, uint32_t sleep_ms);
+
+/**
+ * Drop this device's own activity timeouts and apply the inherited ones.
+ *
+ * @return 0 on success or if it had none, -EINVAL if they were rejected
+ */
+int zmk_activity_settings_drop_own(void);
+
+/** Whether this device has its own activity timeouts. */
+bool zmk_activity_settings_has_own(void);
+
+/**
+ * Get the activity timeouts this device inherits from the central, which
+ * are the ones in effect unless it has its own.
+ */
+void zmk_activity_settings_get_inherited(uint32_t *idle_ms,
+                                         uint32_t *sleep_ms);
+
+/**
+ * Persist pending activity settings now instead of waiting for the debounce
+ * window to expire.
+ *
+ * @return 0 on success or if nothing is pending, negative errno otherwise
+ */
+int zmk_activity_settings_flush(void);
@@ -17,6 +17,7 @@ struct zmk_activity_settings_changed {
     uint32_t idle_ms;
     uint32_t sleep_ms;
     uint8_t source; // 0xFF for self, 0 for central, 1+ for peripherals
+    uint8_t dest;   // ZMK_SETTINGS_RELAY_DEST() bitmask of the peripherals
 };
 
 ZMK_EVENT_DECLARE(zmk_activity_settings_changed);
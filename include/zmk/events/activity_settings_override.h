@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+/**
+ * Event raised by the central to give peripherals activity settings of their
+ * own, which they keep when the central's settings change, or to make them
+ * inherit the central's settings again.
+ */
+struct zmk_activity_settings_override {
+    uint32_t idle_ms;
+    uint32_t sleep_ms;
+    bool inherit;    // Drop own settings; idle_ms and sleep_ms are unused
+    uint8_t source;  // 0xFF for self, 0 for central, 1+ for peripherals
+    uint8_t dest;    // ZMK_SETTINGS_RELAY_DEST() bitmask of the peripherals
+};
+
+ZMK_EVENT_DECLARE(zmk_activity_settings_override);
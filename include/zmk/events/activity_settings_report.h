@@ -28,6 +28,7 @@ struct zmk_activity_settings_report {
     uint32_t sleep_ms;
     uint8_t source;      // Source device (0 = central, 1+ = peripheral index)
     uint8_t request_id;  // Matches the request_id from the request
+    bool own;            // Settings of its own, not inherited from the central
 };
 
 ZMK_EVENT_DECLARE(zmk_activity_settings_report);
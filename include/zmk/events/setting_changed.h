@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+/**
+ * Event raised on this device when the value of a registered setting has
+ * changed, whether it was changed locally or by relay. It is not relayed.
+ */
+struct zmk_setting_changed {
+    uint16_t id;  // Setting id in the settings registry
+};
+
+ZMK_EVENT_DECLARE(zmk_setting_changed);
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zmk/event_manager.h>
+
+/**
+ * Destination of a relayed event, as a bitmask of peripheral sources: bit n
+ * addresses the peripheral with source n.
+ */
+#define ZMK_SETTINGS_RELAY_DEST(source) ((uint8_t)BIT(source))
+
+// Every peripheral, including those that have not learnt their source yet
+#define ZMK_SETTINGS_RELAY_DEST_ALL 0xFE
+
+/**
+ * Event raised by a peripheral to learn its source, which only the central
+ * knows. The nonce identifies the peripheral in the answer, since the answer
+ * reaches every peripheral.
+ */
+struct zmk_settings_address_request {
+    uint32_t nonce;  // Random, chosen by the peripheral at boot
+    uint8_t source;  // Source device (0 = central, 1+ = peripheral index)
+};
+
+ZMK_EVENT_DECLARE(zmk_settings_address_request);
+
+/**
+ * Event raised by the central to tell the peripheral that sent @p nonce its
+ * source.
+ */
+struct zmk_settings_address_assign {
+    uint32_t nonce;
+    uint8_t address;  // Source of the peripheral as seen by the central
+};
+
+ZMK_EVENT_DECLARE(zmk_settings_address_assign);
+
+/**
+ * Whether this device is a destination of @p dest. Always true on the
+ * central. A peripheral that has not learnt its source yet is only addressed
+ * by ZMK_SETTINGS_RELAY_DEST_ALL.
+ */
+bool zmk_settings_relay_addressed(uint8_t dest);
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+/**
+ * Event raised to ask peripherals for a digest of their settings.
+ * Sent from central to peripherals when a peripheral (re)connects.
+ */
+struct zmk_settings_digest_request {
+    uint8_t seq;  // Echoed in the reports, to drop digests of older requests
+};
+
+ZMK_EVENT_DECLARE(zmk_settings_digest_request);
+
+/**
+ * Event raised to report the digest of a peripheral's relayed settings.
+ * Sent from peripheral to central in response to a digest request.
+ */
+struct zmk_settings_digest_report {
+    uint32_t generation;  // Settings generation of the peripheral
+    uint32_t crc;         // zmk_settings_digest() of the peripheral
+    uint8_t source;       // Source device (0 = central, 1+ = peripheral index)
+    uint8_t seq;          // Matches the seq from the request
+};
+
+ZMK_EVENT_DECLARE(zmk_settings_digest_report);
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_changed.h>
+#include <zmk/events/activity_settings_override.h>
+#include <zmk/events/activity_settings_report.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_digest.h>
+
+/**
+ * Wire layout of the relayed events, as a list of F(kind, field) entries.
+ * Fields are written in order, packed and little-endian, with no padding.
+ * The source and destination fields are not sent: they travel in the
+ * envelope.
+ */
+#define ZMK_ACTIVITY_SETTINGS_CHANGED_WIRE(F) F(u32, idle_ms) F(u32, sleep_ms)
+
+#define ZMK_ACTIVITY_SETTINGS_REQUEST_WIRE(F) F(u8, request_id)
+
+#define ZMK_ACTIVITY_SETTINGS_REPORT_WIRE(F) \
+    F(u32, idle_ms) F(u32, sleep_ms) F(u8, request_id) F(u8, own)
+
+#define ZMK_ACTIVITY_SETTINGS_OVERRIDE_WIRE(F) \
+    F(u32, idle_ms) F(u32, sleep_ms) F(u8, inherit)
+
+#define ZMK_SETTINGS_DIGEST_REQUEST_WIRE(F) F(u8, seq)
+
+#define ZMK_SETTINGS_DIGEST_REPORT_WIRE(F) \
+    F(u32, generation) F(u32, crc) F(u8, seq)
+
+#define ZMK_SETTINGS_ADDRESS_REQUEST_WIRE(F) F(u32, nonce)
+
+#define ZMK_SETTINGS_ADDRESS_ASSIGN_WIRE(F) F(u32, nonce) F(u8, address)
+
+/**
+ * Events relayed between central and peripherals in compact mode.
+ *
+ * X(id, type, source_field, dest_field, direction, kind, wire)
+ * - id: 16-bit relay id, sent on the split link instead of the type name.
+ *   Ids must be unique (duplicates fail the build) and kept dense, since
+ *   receivers dispatch through a table indexed by id.
+ * - type: event type name
+ * - source_field: field set to the sender's source on receipt (may be empty)
+ * - dest_field: field with the ZMK_SETTINGS_RELAY_DEST() bitmask of the
+ *   peripherals the event is for (may be empty to address all of them).
+ *   Peripherals that are not addressed drop the event on receipt.
+ * - direction: CENTRAL_TO_PERIPHERAL or PERIPHERAL_TO_CENTRAL
+ * - kind: STATE if only the latest value matters, so a newer event replaces
+ *   one that has not been sent yet, or COMMAND if every event must be sent
+ * - wire: wire layout of the event's fields
+ */
+#define ZMK_SETTINGS_RELAY_EVENTS(X)                                     \
+    X(0x0001, zmk_activity_settings_changed, source, dest,               \
+      CENTRAL_TO_PERIPHERAL, STATE, ZMK_ACTIVITY_SETTINGS_CHANGED_WIRE)  \
+    X(0x0002, zmk_activity_settings_request, , , CENTRAL_TO_PERIPHERAL,  \
+      COMMAND, ZMK_ACTIVITY_SETTINGS_REQUEST_WIRE)                       \
+    X(0x0003, zmk_activity_settings_report, source, ,                    \
+      PERIPHERAL_TO_CENTRAL, COMMAND, ZMK_ACTIVITY_SETTINGS_REPORT_WIRE) \
+    X(0x0004, zmk_settings_digest_request, , , CENTRAL_TO_PERIPHERAL,    \
+      COMMAND, ZMK_SETTINGS_DIGEST_REQUEST_WIRE)                         \
+    X(0x0005, zmk_settings_digest_report, source, ,                      \
+      PERIPHERAL_TO_CENTRAL, COMMAND, ZMK_SETTINGS_DIGEST_REPORT_WIRE)   \
+    X(0x0006, zmk_settings_address_request, source, ,                    \
+      PERIPHERAL_TO_CENTRAL, COMMAND, ZMK_SETTINGS_ADDRESS_REQUEST_WIRE) \
+    X(0x0007, zmk_settings_address_assign, , , CENTRAL_TO_PERIPHERAL,    \
+      COMMAND, ZMK_SETTINGS_ADDRESS_ASSIGN_WIRE)                         \
+    X(0x0008, zmk_activity_settings_override, source, dest,              \
+      CENTRAL_TO_PERIPHERAL, STATE, ZMK_ACTIVITY_SETTINGS_OVERRIDE_WIRE)
+
+#define Z_SETTINGS_RELAY_WIRE_SIZE_u8  1
+#define Z_SETTINGS_RELAY_WIRE_SIZE_s8  1
+#define Z_SETTINGS_RELAY_WIRE_SIZE_u16 2
+#define Z_SETTINGS_RELAY_WIRE_SIZE_u32 4
+
+#define Z_SETTINGS_RELAY_WIRE_FIELD_SIZE(kind, field) \
+    +Z_SETTINGS_RELAY_WIRE_SIZE_##kind
+
+/** Encoded size of an event with the given wire layout. */
+#define ZMK_SETTINGS_RELAY_WIRE_SIZE(wire) \
+    (0 wire(Z_SETTINGS_RELAY_WIRE_FIELD_SIZE))
+
+static inline uint8_t *z_settings_relay_put_u8(uint8_t *buf, uint8_t val) {
+    *buf = val;
+    return buf + 1;
+}
+
+static inline uint8_t *z_settings_relay_put_s8(uint8_t *buf, int8_t val) {
+    *buf = (uint8_t)val;
+    return buf + 1;
+}
+
+static inline uint8_t *z_settings_relay_put_u16(uint8_t *buf, uint16_t val) {
+    sys_put_le16(val, buf);
+    return buf + 2;
+}
+
+static inline uint8_t *z_settings_relay_put_u32(uint8_t *buf, uint32_t val) {
+    sys_put_le32(val, buf);
+    return buf + 4;
+}
+
+#define Z_SETTINGS_RELAY_GET_u8(buf)  (*(buf))
+#define Z_SETTINGS_RELAY_GET_s8(buf)  ((int8_t)*(buf))
+#define Z_SETTINGS_RELAY_GET_u16(buf) sys_get_le16(buf)
+#define Z_SETTINGS_RELAY_GET_u32(buf) sys_get_le32(buf)
+
+#define Z_SETTINGS_RELAY_ENCODE_FIELD(kind, field) \
+    buf = z_settings_relay_put_##kind(buf, ev->field);
+
+#define Z_SETTINGS_RELAY_DECODE_FIELD(kind, field)       \
+    ev->field = Z_SETTINGS_RELAY_GET_##kind(buf);        \
+    buf += Z_SETTINGS_RELAY_WIRE_SIZE_##kind;
+
+/**
+ * Define <type>_relay_encode() and <type>_relay_decode() for a relayed event.
+ *
+ * Encode writes ZMK_SETTINGS_RELAY_WIRE_SIZE(wire) bytes and returns that
+ * count. Decode returns -EINVAL if @p len does not match the wire size and
+ * leaves fields that are not on the wire untouched.
+ */
+#define ZMK_SETTINGS_RELAY_CODEC_DEFINE(relay_id, type, source_field,      \
+                                        dest_field, direction, kind, wire) \
+    static inline uint8_t type##_relay_encode(                             \
+        const struct type *ev, uint8_t *buf) {                             \
+        wire(Z_SETTINGS_RELAY_ENCODE_FIELD);                               \
+        return ZMK_SETTINGS_RELAY_WIRE_SIZE(wire);                         \
+    }                                                                      \
+    static inline int type##_relay_decode(                                 \
+        struct type *ev, const uint8_t *buf, uint8_t len) {                \
+        if (len != ZMK_SETTINGS_RELAY_WIRE_SIZE(wire)) {                   \
+            return -EINVAL;                                                \
+        }                                                                  \
+        wire(Z_SETTINGS_RELAY_DECODE_FIELD);                               \
+        return 0;                                                          \
+    }
+
+ZMK_SETTINGS_RELAY_EVENTS(ZMK_SETTINGS_RELAY_CODEC_DEFINE)
+
+/**
+ * Payload storage sized to the largest encoded event in
+ * ZMK_SETTINGS_RELAY_EVENTS.
+ */
+union zmk_settings_relay_payload {
+#define Z_SETTINGS_RELAY_PAYLOAD_MEMBER(relay_id, type, source_field,      \
+                                        dest_field, direction, kind, wire) \
+    uint8_t type[ZMK_SETTINGS_RELAY_WIRE_SIZE(wire)];
+    ZMK_SETTINGS_RELAY_EVENTS(Z_SETTINGS_RELAY_PAYLOAD_MEMBER)
+#undef Z_SETTINGS_RELAY_PAYLOAD_MEMBER
+};
+
+#define ZMK_SETTINGS_RELAY_DATA_LEN sizeof(union zmk_settings_relay_payload)
+
+/**
+ * Relay id of acknowledgements in reliable mode. The envelope's seq is the
+ * one acknowledged, and the payload is ZMK_SETTINGS_RELAY_ACK_WIRE.
+ */
+#define ZMK_SETTINGS_RELAY_ID_ACK 0x0000
+
+#define ZMK_SETTINGS_RELAY_ACK_WIRE(F) F(u16, id) F(s8, status)
+
+struct zmk_settings_relay_ack {
+    uint16_t id;    // Relay id of the acknowledged event
+    int8_t status;  // 0, or the negative errno of raising it on the receiver
+};
+
+ZMK_SETTINGS_RELAY_CODEC_DEFINE(ZMK_SETTINGS_RELAY_ID_ACK,
+                                zmk_settings_relay_ack, , , , ,
+                                ZMK_SETTINGS_RELAY_ACK_WIRE)
+
+/**
+ * One past the highest relay id, including ZMK_SETTINGS_RELAY_ID_ACK. Ids
+ * are dense, so tables indexed by relay id are this long.
+ */
+union z_settings_relay_ids {
+    uint8_t zmk_settings_relay_ack[ZMK_SETTINGS_RELAY_ID_ACK + 1];
+#define Z_SETTINGS_RELAY_ID_MEMBER(relay_id, type, source_field, dest_field, \
+                                   direction, kind, wire)                    \
+    uint8_t type[(relay_id) + 1];
+    ZMK_SETTINGS_RELAY_EVENTS(Z_SETTINGS_RELAY_ID_MEMBER)
+#undef Z_SETTINGS_RELAY_ID_MEMBER
+};
+
+#define ZMK_SETTINGS_RELAY_ID_COUNT sizeof(union z_settings_relay_ids)
+
+/**
+ * Envelope carrying one of ZMK_SETTINGS_RELAY_EVENTS over the split link.
+ * It is the only event type this module relays in compact mode. The id is
+ * little-endian and the struct is packed, so the layout does not depend on
+ * the ABI of either side.
+ */
+struct zmk_settings_relay {
+    uint16_t id;     // Little-endian relay id
+    uint8_t source;  // 0xFF for self, 0 for central, 1+ for peripherals
+    uint8_t seq;     // Sequence number to acknowledge, 0 if not reliable
+    uint8_t dest;    // ZMK_SETTINGS_RELAY_DEST() bitmask of the recipients
+    uint8_t len;     // Encoded length of data
+    uint8_t data[ZMK_SETTINGS_RELAY_DATA_LEN];
+} __packed;
+
+ZMK_EVENT_DECLARE(zmk_settings_relay);
+
+/**
+ * Event raised on the central with the outcome of a reliable relay for one
+ * peripheral: once it acknowledges the event, or once all retransmits have
+ * gone unacknowledged.
+ */
+struct zmk_settings_relay_delivery {
+    uint16_t id;       // Relay id of the event
+    uint8_t source;    // Peripheral the outcome is for
+    uint8_t attempts;  // Number of times the event was sent
+    int status;  // 0 if applied, -ETIMEDOUT if never acknowledged, or the
+                 // error of raising it on the peripheral
+};
+
+ZMK_EVENT_DECLARE(zmk_settings_relay_delivery);
+
+/**
+ * Fail the build if an event relayed by type name does not fit the split
+ * relay buffers.
+ */
+#define ZMK_SETTINGS_RELAY_ASSERT_FITS(type)                                 \
+    BUILD_ASSERT(sizeof(struct type) <= CONFIG_ZMK_SPLIT_RELAY_EVENT_DATA_LEN, \
+                 #type " exceeds CONFIG_ZMK_SPLIT_RELAY_EVENT_DATA_LEN");     \
+    BUILD_ASSERT(sizeof(#type) <= CONFIG_ZMK_SPLIT_RELAY_EVENT_TYPE_NAME_LEN,  \
+                 #type " exceeds CONFIG_ZMK_SPLIT_RELAY_EVENT_TYPE_NAME_LEN")
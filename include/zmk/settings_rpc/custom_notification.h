@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <pb.h>
+#include <zephyr/kernel.h>
+
+#define ZMK_RPC_CUSTOM_NOTIFIER_UNRESOLVED (-1)
+
+/**
+ * Notification source bound to a custom Studio RPC subsystem.
+ * The subsystem index is looked up by identifier once and cached, so raising
+ * a notification does not scan the zmk_rpc_custom_subsystem section.
+ */
+struct zmk_rpc_custom_notifier {
+    const char *identifier;
+    int index;  // Cached subsystem index, negative until resolved
+};
+
+/**
+ * Define a notifier for the subsystem registered with
+ * ZMK_RPC_CUSTOM_SUBSYSTEM(prefix, ...). The notifier is named
+ * <prefix>_notifier.
+ */
+#define ZMK_RPC_CUSTOM_NOTIFIER_DEFINE(prefix)                    \
+    static struct zmk_rpc_custom_notifier prefix##_notifier = { \
+        .identifier = #prefix,                                   \
+        .index      = ZMK_RPC_CUSTOM_NOTIFIER_UNRESOLVED,        \
+    }
+
+/**
+ * Resolve the subsystem index of the notifier, scanning the subsystem list
+ * only if it has not been resolved yet. Call it from SYS_INIT to move the
+ * lookup out of the notification path entirely.
+ *
+ * @return subsystem index, or -ENOENT if the subsystem is not registered
+ */
+int zmk_rpc_custom_notifier_resolve(struct zmk_rpc_custom_notifier *notifier);
+
+/**
+ * Encode @p message with @p fields as the payload of a custom notification
+ * and raise it for the notifier's subsystem.
+ *
+ * The message is serialized once, before the notification is raised, into a
+ * scratch buffer of CONFIG_ZMK_SETTINGS_RPC_NOTIFICATION_BUFFER_SIZE bytes,
+ * so it may live on the caller's stack.
+ *
+ * @return 0 on success, -ENOENT if the subsystem is not registered,
+ *         -EMSGSIZE if the encoded message does not fit the scratch buffer,
+ *         -EBUSY if called from a listener of the notification being sent
+ */
+int zmk_rpc_custom_notify(struct zmk_rpc_custom_notifier *notifier,
+                          const pb_msgdesc_t *fields, const void *message);
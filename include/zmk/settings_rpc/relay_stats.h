@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/events/settings_relay.h>
+
+// Buckets of the round-trip time histograms, up to 2^23 us (about 8 s)
+#define ZMK_SETTINGS_RELAY_RTT_BUCKETS 24
+
+/** Traffic of one relayed event type on the link to one peripheral. */
+struct zmk_settings_relay_event_stats {
+    uint32_t sent;
+    uint32_t sent_bytes;
+    uint32_t received;
+    uint32_t received_bytes;
+    // Discarded by this module: replaced before being sent, never
+    // acknowledged, or received but not raised
+    uint32_t dropped;
+    // Refused by the split relay when handed to it
+    uint32_t rejected;
+};
+
+/**
+ * Round-trip times of activity settings requests to one peripheral, from
+ * zmk_activity_settings_request being raised on the central to the
+ * peripheral's zmk_activity_settings_report arriving.
+ */
+struct zmk_settings_relay_rtt_stats {
+    uint32_t count;
+    uint32_t max_us;
+    // buckets[i] counts round trips of [2^i, 2^(i+1)) microseconds
+    uint32_t buckets[ZMK_SETTINGS_RELAY_RTT_BUCKETS];
+};
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_STATS)
+
+/**
+ * Count an envelope handed to the split relay. It goes out on the link to
+ * every peripheral, so it is counted for each of them: as sent if @p rc is
+ * the successful result of raising it, as rejected otherwise.
+ */
+void zmk_settings_relay_stats_sent(const struct zmk_settings_relay *relay,
+                                   int rc);
+
+/** Count an envelope received from a peripheral. */
+void zmk_settings_relay_stats_received(const struct zmk_settings_relay *relay);
+
+/**
+ * Count an envelope received from a peripheral as dropped, because it could
+ * not be decoded or raised.
+ */
+void zmk_settings_relay_stats_discarded(const struct zmk_settings_relay *relay);
+
+/**
+ * Count an envelope with relay id @p id as dropped for the peripherals set in
+ * @p sources, a bitmask with BIT(source) per peripheral.
+ */
+void zmk_settings_relay_stats_dropped(uint16_t id, uint32_t sources);
+
+/**
+ * Copy the statistics of the link to peripheral @p source. @p events is
+ * indexed by relay id.
+ *
+ * @return 0 on success, -EINVAL if @p source is not a peripheral
+ */
+int zmk_settings_relay_stats_get(
+    uint8_t source,
+    struct zmk_settings_relay_event_stats events[ZMK_SETTINGS_RELAY_ID_COUNT],
+    struct zmk_settings_relay_rtt_stats *rtt);
+
+#else
+
+static inline void
+zmk_settings_relay_stats_sent(const struct zmk_settings_relay *relay, int rc) {}
+
+static inline void
+zmk_settings_relay_stats_received(const struct zmk_settings_relay *relay) {}
+
+static inline void
+zmk_settings_relay_stats_discarded(const struct zmk_settings_relay *relay) {}
+
+static inline void zmk_settings_relay_stats_dropped(uint16_t id,
+                                                    uint32_t sources) {}
+
+static inline int zmk_settings_relay_stats_get(
+    uint8_t source,
+    struct zmk_settings_relay_event_stats events[ZMK_SETTINGS_RELAY_ID_COUNT],
+    struct zmk_settings_relay_rtt_stats *rtt) {
+    return -ENOTSUP;
+}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_STATS)
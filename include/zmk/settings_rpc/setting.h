@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/util.h>
+
+enum zmk_setting_type {
+    ZMK_SETTING_TYPE_UINT32,
+    ZMK_SETTING_TYPE_BOOL,
+};
+
+/** How a setting is kept across resets. */
+enum zmk_setting_persist {
+    ZMK_SETTING_PERSIST_NONE,
+    // Saved by the setter after a debounce window
+    ZMK_SETTING_PERSIST_DEBOUNCED,
+};
+
+/** Where a setting takes effect on a split keyboard. */
+enum zmk_setting_relay {
+    ZMK_SETTING_RELAY_NONE,
+    // Relayed by the setter from the central to the peripherals, and by
+    // relay_to to peripherals that missed changes
+    ZMK_SETTING_RELAY_PERIPHERALS,
+};
+
+/**
+ * Settings that are validated and applied together, such as the idle and
+ * sleep timeouts. Both callbacks get the values of all settings indexed by
+ * id, with the proposed values of the settings being changed and the
+ * current values of the others.
+ */
+struct zmk_setting_group {
+    // Check the group's values as a whole (optional)
+    bool (*validate)(const uint32_t *values);
+    // Apply the group's values in one step: 0 on success, negative errno
+    // otherwise, with none of the values changed
+    int (*apply)(const uint32_t *values);
+    // Relay the group's current values to the peripherals in the
+    // ZMK_SETTINGS_RELAY_DEST() bitmask dest (required if they are relayed)
+    int (*relay_to)(uint8_t dest);
+};
+
+/**
+ * Descriptor of a setting exposed through the generic settings RPCs.
+ *
+ * Settings are looked up by id through a table built at boot, so dispatch
+ * does not depend on the number of settings. A setting is applied either by
+ * its own setter or, if it belongs to a group, together with the rest of its
+ * group. Both are only called with values within [min, max]; they apply the
+ * values and implement the persist and relay policies, which are declared
+ * here for clients to discover.
+ */
+struct zmk_setting {
+    uint16_t id;
+    const char *name;
+    enum zmk_setting_type type;
+    uint32_t min;
+    uint32_t max;
+    uint32_t (*get)(void);
+    // Value inherited from the central, for relayed settings a device may
+    // hold its own value of (optional, get is used if NULL)
+    uint32_t (*inherited)(void);
+    int (*set)(uint32_t value);  // 0 on success, negative errno otherwise
+    // Relay the current value to the peripherals in the
+    // ZMK_SETTINGS_RELAY_DEST() bitmask dest (required if it is relayed)
+    int (*relay_to)(uint8_t dest);
+    const struct zmk_setting_group *group;  // Replaces set and relay_to if set
+    enum zmk_setting_persist persist;
+    enum zmk_setting_relay relay;
+};
+
+/**
+ * Register a setting. @p _id must be a constant expression in
+ * 1..CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID. Registering two settings with
+ * the same id is an error reported when the settings table is built at
+ * boot. Remaining fields are given as designated initializers.
+ *
+ * @code
+ * ZMK_SETTING_DEFINE(idle_ms, ZMK_SETTING_ID_IDLE_MS,
+ *                    .type = ZMK_SETTING_TYPE_UINT32, .max = UINT32_MAX,
+ *                    .get = get_idle_ms, .group = &activity_timeouts);
+ * @endcode
+ */
+#define ZMK_SETTING_DEFINE(_name, _id, ...)                                   \
+    BUILD_ASSERT((_id) > 0 && (_id) <= CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID, \
+                 "Setting id of " #_name " is out of range");                 \
+    STRUCT_SECTION_ITERABLE(zmk_setting, zmk_setting_##_name) = {             \
+        .id   = (_id),                                                        \
+        .name = #_name,                                                       \
+        __VA_ARGS__}
+
+/**
+ * Find a registered setting.
+ *
+ * @return the setting, or NULL if no setting has this id
+ */
+const struct zmk_setting *zmk_setting_find(uint32_t id);
+
+/**
+ * Read a setting.
+ *
+ * @return 0 on success, -ENOENT if no setting has this id
+ */
+int zmk_setting_get(uint32_t id, uint32_t *value);
+
+/** A setting id with a value. */
+struct zmk_setting_value {
+    uint32_t id;
+    uint32_t value;
+};
+
+/**
+ * Validate @p value against the bounds of the setting and apply it.
+ *
+ * @return 0 on success, -ENOENT if no setting has this id, -ERANGE if the
+ *         value is out of bounds, -EINVAL if its group rejects it, or the
+ *         error returned by the setter
+ */
+int zmk_setting_set(uint32_t id, uint32_t value);
+
+/**
+ * Apply several settings at once, all or nothing.
+ *
+ * All values are checked against their bounds and their groups before any of
+ * them is applied. Each group is then applied once with all of its new
+ * values. If applying fails, the settings already applied are restored.
+ *
+ * @return 0 on success, -ENOENT if an id is unknown, -EINVAL if an id is
+ *         given twice or a group rejects its values, -ERANGE if a value is
+ *         out of bounds, or the error returned by the failing setter
+ */
+int zmk_setting_set_batch(const struct zmk_setting_value *values,
+                          size_t count);
+
+/**
+ * Relay the current value of every relayed setting to the peripherals in the
+ * ZMK_SETTINGS_RELAY_DEST() bitmask @p dest, whether or not it changed. Used
+ * to bring a peripheral that missed changes back in line.
+ *
+ * @return 0 on success, or the error of the first failing relay
+ */
+int zmk_settings_relay_to(uint8_t dest);
+
+/**
+ * CRC-32 over the ids and values of the relayed settings of this device, as
+ * inherited from the central. Two devices with the same digest hold the same
+ * relayed settings, apart from those they have their own values of.
+ */
+uint32_t zmk_settings_digest(void);
+
+/**
+ * Generation of the settings of this device. It changes whenever a setting
+ * is changed, locally or by relay, so clients can skip re-reading settings
+ * that have not changed. It starts from a random value at boot and is never
+ * 0, so a generation seen before a reset is unlikely to match.
+ */
+uint32_t zmk_settings_generation(void);
+
+/**
+ * Advance the settings generation. Called by setting owners whenever a value
+ * actually changes.
+ */
+void zmk_settings_generation_bump(void);
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/**
+ * Module code paths that stack use is sampled on, matching the StackPath
+ * values of the settings RPC protocol.
+ */
+enum zmk_settings_stack_path {
+    ZMK_SETTINGS_STACK_PATH_RPC,
+    ZMK_SETTINGS_STACK_PATH_NOTIFICATION,
+    ZMK_SETTINGS_STACK_PATH_RELAY_SEND,
+    ZMK_SETTINGS_STACK_PATH_RELAY_RECEIVE,
+    ZMK_SETTINGS_STACK_PATH_EVENT,
+    ZMK_SETTINGS_STACK_PATH_COUNT,
+};
+
+// Threads tracked at once; further threads are not sampled
+#define ZMK_SETTINGS_STACK_USAGE_MAX_THREADS 8
+
+struct zmk_settings_stack_usage {
+    const struct k_thread *thread;
+    // Stack size and peak use in bytes
+    size_t size;
+    size_t peak;
+    // Bit n is set if path n has run on the thread
+    uint32_t paths;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STACK_USAGE)
+
+/**
+ * Record the peak stack use of the current thread, which is running module
+ * code on @p path. The whole stack is checked, so this costs time in
+ * proportion to the unused part of the stack.
+ */
+void zmk_settings_stack_sample(enum zmk_settings_stack_path path);
+
+/**
+ * Copy the recorded stack use of up to @p max threads into @p usage, in the
+ * order the threads were first sampled.
+ *
+ * @return number of threads copied
+ */
+size_t zmk_settings_stack_usage_get(struct zmk_settings_stack_usage *usage,
+                                    size_t max);
+
+#else
+
+static inline void
+zmk_settings_stack_sample(enum zmk_settings_stack_path path) {}
+
+static inline size_t
+zmk_settings_stack_usage_get(struct zmk_settings_stack_usage *usage,
+                             size_t max) {
+    return 0;
+}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STACK_USAGE)
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * Number of peripherals the central relays settings to and collects them
+ * from. Peripherals have sources 1..ZMK_SETTINGS_RPC_PERIPHERAL_COUNT; there
+ * are none on peripherals and without the split relay.
+ */
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#if defined(CONFIG_ZMK_SPLIT_BLE_CENTRAL_PERIPHERALS)
+#define ZMK_SETTINGS_RPC_PERIPHERAL_COUNT \
+    CONFIG_ZMK_SPLIT_BLE_CENTRAL_PERIPHERALS
+#else
+#define ZMK_SETTINGS_RPC_PERIPHERAL_COUNT 1
+#endif
+#else
+#define ZMK_SETTINGS_RPC_PERIPHERAL_COUNT 0
+#endif
+
+// Bitmask with one bit per peripheral source
+#define ZMK_SETTINGS_RPC_ALL_PERIPHERALS_MASK \
+    ((uint32_t)BIT_MASK(ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) << 1)
+
+/**
+ * Bucket of @p us microseconds in a log2 histogram of @p buckets buckets:
+ * floor(log2(us)), with 0 and 1 both in the first bucket and longer times
+ * in the last one.
+ */
+static inline uint32_t zmk_settings_rpc_log2_bucket(uint32_t us,
+                                                    uint32_t buckets) {
+    uint32_t bucket = us > 1 ? 31 - __builtin_clz(us) : 0;
+    return MIN(bucket, buckets - 1);
+}
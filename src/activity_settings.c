@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Activity timeouts changed through this module.
+ *
+ * Both timeouts are validated and applied as a pair. Changes are applied to
+ * the activity subsystem right away, but only the final value of a burst of
+ * changes is written to flash: the save is debounced, and both timeouts are
+ * stored as a single settings record. The activity setters are expected to
+ * change the timeouts in RAM only; see CONFIG_ZMK_SETTINGS_RPC_PERSIST.
+ *
+ * A device with its own timeouts also keeps the central's, so it can inherit
+ * them again. Without own timeouts, the inherited ones are those in effect.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_changed.h>
+#include <zmk/events/activity_settings_override.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/setting_changed.h>
+#include <zmk/settings_rpc/setting.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+static bool own;
+// Timeouts of the central, only kept while this device has its own
+static uint32_t inherited_idle_ms;
+static uint32_t inherited_sleep_ms;
+static K_MUTEX_DEFINE(own_lock);
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_PERSIST)
+
+#define ACTIVITY_SETTINGS_KEY "settings_rpc/activity"
+
+struct activity_settings_record {
+    uint32_t idle_ms;
+    uint32_t sleep_ms;
+    // Timeouts of the central, if this device has its own
+    uint32_t inherited_idle_ms;
+    uint32_t inherited_sleep_ms;
+    bool own;
+};
+
+// Records written before devices could have their own timeouts
+#define ACTIVITY_SETTINGS_RECORD_V1_SIZE \
+    offsetof(struct activity_settings_record, inherited_idle_ms)
+
+// Last record written to or loaded from flash
+static struct activity_settings_record saved;
+static bool dirty;
+static K_MUTEX_DEFINE(save_lock);
+
+static void save_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(save_work, save_work_handler);
+
+int zmk_activity_settings_flush(void) {
+    k_work_cancel_delayable(&save_work);
+
+    // Persist what is in effect now, which is the last value applied. Zeroed
+    // first so padding compares equal.
+    struct activity_settings_record record;
+    memset(&record, 0, sizeof(record));
+    k_mutex_lock(&own_lock, K_FOREVER);
+    record.idle_ms  = zmk_activity_get_idle_ms();
+    record.sleep_ms = zmk_activity_get_sleep_ms();
+    record.own      = own;
+    if (own) {
+        record.inherited_idle_ms  = inherited_idle_ms;
+        record.inherited_sleep_ms = inherited_sleep_ms;
+    }
+    k_mutex_unlock(&own_lock);
+
+    k_mutex_lock(&save_lock, K_FOREVER);
+    if (!dirty) {
+        k_mutex_unlock(&save_lock);
+        return 0;
+    }
+
+    int rc = 0;
+    if (memcmp(&record, &saved, sizeof(record)) != 0) {
+        rc = settings_save_one(ACTIVITY_SETTINGS_KEY, &record, sizeof(record));
+    }
+    if (rc == 0) {
+        saved = record;
+        dirty = false;
+        LOG_DBG("Saved activity settings: idle=%d ms, sleep=%d ms",
+                record.idle_ms, record.sleep_ms);
+    } else {
+        LOG_ERR("Failed to save activity settings: %d", rc);
+    }
+    k_mutex_unlock(&save_lock);
+    return rc;
+}
+
+static void save_work_handler(struct k_work *work) {
+    zmk_activity_settings_flush();
+}
+
+static void schedule_save(void) {
+    k_mutex_lock(&save_lock, K_FOREVER);
+    dirty = true;
+    k_mutex_unlock(&save_lock);
+
+    // Restart the window on every change so a burst is written once
+    k_work_reschedule(&save_work,
+                      K_MSEC(CONFIG_ZMK_SETTINGS_RPC_SAVE_DEBOUNCE_MS));
+}
+
+static int activity_settings_load(const char *name, size_t len,
+                                  settings_read_cb read_cb, void *cb_arg) {
+    const char *next;
+    if (!settings_name_steq(name, "activity", &next) || next) {
+        return -ENOENT;
+    }
+    if (len != sizeof(struct activity_settings_record) &&
+        len != ACTIVITY_SETTINGS_RECORD_V1_SIZE) {
+        LOG_WRN("Ignoring activity settings record of size %zu", len);
+        return -EINVAL;
+    }
+
+    // Older records leave the device inheriting the central's timeouts
+    struct activity_settings_record record;
+    memset(&record, 0, sizeof(record));
+    int rc = read_cb(cb_arg, &record, len);
+    if (rc < 0) {
+        return rc;
+    }
+
+    k_mutex_lock(&save_lock, K_FOREVER);
+    saved = record;
+    k_mutex_unlock(&save_lock);
+
+    k_mutex_lock(&own_lock, K_FOREVER);
+    own                = record.own;
+    inherited_idle_ms  = record.inherited_idle_ms;
+    inherited_sleep_ms = record.inherited_sleep_ms;
+    zmk_activity_set_idle_ms(record.idle_ms);
+    zmk_activity_set_sleep_ms(record.sleep_ms);
+    k_mutex_unlock(&own_lock);
+    LOG_DBG("Loaded activity settings: idle=%d ms, sleep=%d ms%s",
+            record.idle_ms, record.sleep_ms, record.own ? " (own)" : "");
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(settings_rpc, "settings_rpc", NULL,
+                               activity_settings_load, NULL, NULL);
+
+/**
+ * Write pending settings before the keyboard goes to sleep, since the
+ * debounce work would not run again before power off.
+ */
+static int activity_settings_state_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev =
+        as_zmk_activity_state_changed(eh);
+    if (ev && ev->state == ZMK_ACTIVITY_SLEEP) {
+        zmk_activity_settings_flush();
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_persist, activity_settings_state_listener);
+ZMK_SUBSCRIPTION(activity_settings_persist, zmk_activity_state_changed);
+
+#else
+
+int zmk_activity_settings_flush(void) { return 0; }
+
+static void schedule_save(void) {}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_PERSIST)
+
+bool zmk_activity_settings_valid(uint32_t idle_ms, uint32_t sleep_ms) {
+    // 0 disables a timeout; otherwise the keyboard must go idle before sleep
+    return idle_ms == 0 || sleep_ms == 0 || sleep_ms >= idle_ms;
+}
+
+int zmk_activity_settings_apply(uint32_t idle_ms, uint32_t sleep_ms) {
+    if (!zmk_activity_settings_valid(idle_ms, sleep_ms)) {
+        LOG_WRN("Rejected activity settings: idle=%d ms, sleep=%d ms",
+                idle_ms, sleep_ms);
+        return -EINVAL;
+    }
+
+    uint32_t prev_idle_ms  = zmk_activity_get_idle_ms();
+    uint32_t prev_sleep_ms = zmk_activity_get_sleep_ms();
+    if (!zmk_activity_set_idle_ms(idle_ms)) {
+        LOG_ERR("Failed to set idle timeout to %d ms", idle_ms);
+        return -EINVAL;
+    }
+
+    if (!zmk_activity_set_sleep_ms(sleep_ms)) {
+        LOG_ERR("Failed to set sleep timeout to %d ms", sleep_ms);
+        // Keep the pair consistent: roll back the idle timeout
+        zmk_activity_set_idle_ms(prev_idle_ms);
+        return -EINVAL;
+    }
+
+    if (idle_ms == prev_idle_ms && sleep_ms == prev_sleep_ms) {
+        return 0;
+    }
+
+    zmk_settings_generation_bump();
+    if (idle_ms != prev_idle_ms) {
+        raise_zmk_setting_changed(
+            (struct zmk_setting_changed){.id = ZMK_SETTING_ID_IDLE_MS});
+    }
+    if (sleep_ms != prev_sleep_ms) {
+        raise_zmk_setting_changed(
+            (struct zmk_setting_changed){.id = ZMK_SETTING_ID_SLEEP_MS});
+    }
+    schedule_save();
+    return 0;
+}
+
+int zmk_activity_set_timeouts(uint32_t idle_ms, uint32_t sleep_ms) {
+    uint32_t prev_idle_ms  = zmk_activity_get_idle_ms();
+    uint32_t prev_sleep_ms = zmk_activity_get_sleep_ms();
+    int rc                 = zmk_activity_settings_apply(idle_ms, sleep_ms);
+    if (rc < 0 || (idle_ms == prev_idle_ms && sleep_ms == prev_sleep_ms)) {
+        return rc;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+    // Propagate to peripherals, which apply them unless they have their own
+    struct zmk_activity_settings_changed event = {
+        .idle_ms  = idle_ms,
+        .sleep_ms = sleep_ms,
+        .source   = ZMK_RELAY_EVENT_SOURCE_SELF,
+        .dest     = ZMK_SETTINGS_RELAY_DEST_ALL,
+    };
+    raise_zmk_activity_settings_changed(event);
+#endif
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+static void raise_override(uint32_t idle_ms, uint32_t sleep_ms, bool inherit,
+                           uint8_t dest) {
+    // Settings seen through the central change with the peripherals'
+    zmk_settings_generation_bump();
+
+    struct zmk_activity_settings_override event = {
+        .idle_ms  = idle_ms,
+        .sleep_ms = sleep_ms,
+        .inherit  = inherit,
+        .source   = ZMK_RELAY_EVENT_SOURCE_SELF,
+        .dest     = dest,
+    };
+    raise_zmk_activity_settings_override(event);
+}
+#endif
+
+int zmk_activity_set_timeouts_on(uint32_t idle_ms, uint32_t sleep_ms,
+                                 bool local, uint8_t dest) {
+    if (!zmk_activity_settings_valid(idle_ms, sleep_ms)) {
+        LOG_WRN("Rejected activity settings: idle=%d ms, sleep=%d ms",
+                idle_ms, sleep_ms);
+        return -EINVAL;
+    }
+
+    if (local) {
+        int rc = zmk_activity_set_timeouts(idle_ms, sleep_ms);
+        if (rc < 0) {
+            return rc;
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+    if (dest != 0) {
+        raise_override(idle_ms, sleep_ms, false, dest);
+    }
+#endif
+    return 0;
+}
+
+int zmk_activity_settings_inherit_on(uint8_t dest) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+    if (dest != 0) {
+        raise_override(0, 0, true, dest);
+    }
+#endif
+    return 0;
+}
+
+int zmk_activity_settings_apply_inherited(uint32_t idle_ms,
+                                          uint32_t sleep_ms) {
+    k_mutex_lock(&own_lock, K_FOREVER);
+    int rc = 0;
+    if (!own) {
+        rc = zmk_activity_settings_apply(idle_ms, sleep_ms);
+    } else if (!zmk_activity_settings_valid(idle_ms, sleep_ms)) {
+        rc = -EINVAL;
+    } else {
+        // Kept for when this device drops its own timeouts
+        inherited_idle_ms  = idle_ms;
+        inherited_sleep_ms = sleep_ms;
+        schedule_save();
+    }
+    k_mutex_unlock(&own_lock);
+    return rc;
+}
+
+int zmk_activity_settings_apply_own(uint32_t idle_ms, uint32_t sleep_ms) {
+    k_mutex_lock(&own_lock, K_FOREVER);
+    uint32_t prev_idle_ms  = zmk_activity_get_idle_ms();
+    uint32_t prev_sleep_ms = zmk_activity_get_sleep_ms();
+    int rc                 = zmk_activity_settings_apply(idle_ms, sleep_ms);
+    if (rc == 0 && !own) {
+        // The timeouts in effect until now were the inherited ones
+        own                = true;
+        inherited_idle_ms  = prev_idle_ms;
+        inherited_sleep_ms = prev_sleep_ms;
+        zmk_settings_generation_bump();
+        schedule_save();
+    }
+    k_mutex_unlock(&own_lock);
+    return rc;
+}
+
+int zmk_activity_settings_drop_own(void) {
+    k_mutex_lock(&own_lock, K_FOREVER);
+    int rc = 0;
+    if (own) {
+        rc = zmk_activity_settings_apply(inherited_idle_ms, inherited_sleep_ms);
+        if (rc == 0) {
+            own = false;
+            zmk_settings_generation_bump();
+            schedule_save();
+        }
+    }
+    k_mutex_unlock(&own_lock);
+    return rc;
+}
+
+bool zmk_activity_settings_has_own(void) {
+    k_mutex_lock(&own_lock, K_FOREVER);
+    bool has_own = own;
+    k_mutex_unlock(&own_lock);
+    return has_own;
+}
+
+void zmk_activity_settings_get_inherited(uint32_t *idle_ms,
+                                         uint32_t *sleep_ms) {
+    k_mutex_lock(&own_lock, K_FOREVER);
+    *idle_ms  = own ? inherited_idle_ms : zmk_activity_get_idle_ms();
+    *sleep_ms = own ? inherited_sleep_ms : zmk_activity_get_sleep_ms();
+    k_mutex_unlock(&own_lock);
+}
+
+static uint32_t get_idle_ms(void) { return zmk_activity_get_idle_ms(); }
+
+static uint32_t get_sleep_ms(void) { return zmk_activity_get_sleep_ms(); }
+
+static uint32_t get_inherited_idle_ms(void) {
+    uint32_t idle_ms, sleep_ms;
+    zmk_activity_settings_get_inherited(&idle_ms, &sleep_ms);
+    return idle_ms;
+}
+
+static uint32_t get_inherited_sleep_ms(void) {
+    uint32_t idle_ms, sleep_ms;
+    zmk_activity_settings_get_inherited(&idle_ms, &sleep_ms);
+    return sleep_ms;
+}
+
+static bool activity_timeouts_validate(const uint32_t *values) {
+    return zmk_activity_settings_valid(values[ZMK_SETTING_ID_IDLE_MS],
+                                       values[ZMK_SETTING_ID_SLEEP_MS]);
+}
+
+static int activity_timeouts_apply(const uint32_t *values) {
+    return zmk_activity_set_timeouts(values[ZMK_SETTING_ID_IDLE_MS],
+                                     values[ZMK_SETTING_ID_SLEEP_MS]);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+static int activity_timeouts_relay_to(uint8_t dest) {
+    struct zmk_activity_settings_changed event = {
+        .idle_ms  = zmk_activity_get_idle_ms(),
+        .sleep_ms = zmk_activity_get_sleep_ms(),
+        .source   = ZMK_RELAY_EVENT_SOURCE_SELF,
+        .dest     = dest,
+    };
+    return raise_zmk_activity_settings_changed(event);
+}
+#else
+#define activity_timeouts_relay_to NULL
+#endif
+
+// The timeouts are validated and applied as a pair, even if only one changes
+static const struct zmk_setting_group activity_timeouts = {
+    .validate = activity_timeouts_validate,
+    .apply    = activity_timeouts_apply,
+    .relay_to = activity_timeouts_relay_to,
+};
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_PERSIST)
+#define ACTIVITY_SETTING_PERSIST ZMK_SETTING_PERSIST_DEBOUNCED
+#else
+#define ACTIVITY_SETTING_PERSIST ZMK_SETTING_PERSIST_NONE
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+#define ACTIVITY_SETTING_RELAY ZMK_SETTING_RELAY_PERIPHERALS
+#else
+#define ACTIVITY_SETTING_RELAY ZMK_SETTING_RELAY_NONE
+#endif
+
+ZMK_SETTING_DEFINE(idle_ms, ZMK_SETTING_ID_IDLE_MS,
+                   .type      = ZMK_SETTING_TYPE_UINT32,
+                   .max       = UINT32_MAX,
+                   .get       = get_idle_ms,
+                   .inherited = get_inherited_idle_ms,
+                   .group     = &activity_timeouts,
+                   .persist   = ACTIVITY_SETTING_PERSIST,
+                   .relay     = ACTIVITY_SETTING_RELAY);
+
+ZMK_SETTING_DEFINE(sleep_ms, ZMK_SETTING_ID_SLEEP_MS,
+                   .type      = ZMK_SETTING_TYPE_UINT32,
+                   .max       = UINT32_MAX,
+                   .get       = get_sleep_ms,
+                   .inherited = get_inherited_sleep_ms,
+                   .group     = &activity_timeouts,
+                   .persist   = ACTIVITY_SETTING_PERSIST,
+                   .relay     = ACTIVITY_SETTING_RELAY);
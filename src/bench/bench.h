@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#if IS_ENABLED(CONFIG_TIMING_FUNCTIONS)
+#include <zephyr/timing/timing.h>
+#endif
+
+/**
+ * Minimal cycle counter shared by the settings RPC micro-benchmarks.
+ * Uses the timing API when the target provides one, and the kernel cycle
+ * counter otherwise.
+ */
+#if IS_ENABLED(CONFIG_TIMING_FUNCTIONS)
+typedef timing_t bench_stamp_t;
+
+static inline void bench_init(void) {
+    timing_init();
+    timing_start();
+}
+
+static inline bench_stamp_t bench_now(void) { return timing_counter_get(); }
+
+static inline uint64_t bench_cycles(bench_stamp_t start, bench_stamp_t end) {
+    return timing_cycles_get(&start, &end);
+}
+#else
+typedef uint32_t bench_stamp_t;
+
+static inline void bench_init(void) {}
+
+static inline bench_stamp_t bench_now(void) { return k_cycle_get_32(); }
+
+static inline uint64_t bench_cycles(bench_stamp_t start, bench_stamp_t end) {
+    return (uint32_t)(end - start);
+}
+#endif
+
+/**
+ * Run @p body CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS times and log the
+ * average cycle count per iteration under @p name.
+ */
+#define BENCH_RUN(name, body)                                              \
+    do {                                                                   \
+        bench_stamp_t _start = bench_now();                                \
+        for (int _i = 0; _i < CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS; \
+             _i++) {                                                       \
+            body;                                                          \
+        }                                                                  \
+        uint64_t _cycles = bench_cycles(_start, bench_now());              \
+        LOG_INF("bench %s: %d iterations, %u cycles/op", name,             \
+                CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS,              \
+                (uint32_t)(_cycles /                                       \
+                           CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS)); \
+    } while (0)
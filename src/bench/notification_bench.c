@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Micro-benchmark for the custom notification path.
+ *
+ * Compares resolving the subsystem index by scanning the custom subsystem
+ * list (the lookup previously done for every notification) against the
+ * cached notifier, compares the previous two-pass payload encoding against
+ * the single-pass scratch buffer encoding, and measures a full activity
+ * settings notification.
+ */
+
+#include <pb_encode.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/settings/core.pb.h>
+#include <zmk/settings_rpc/custom_notification.h>
+#include <zmk/studio/custom.h>
+
+#include "bench.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_RPC_CUSTOM_NOTIFIER_DEFINE(zmk__settings);
+
+// Lookup as it was done before the index was cached
+static int scan_subsystem_index(const char *identifier) {
+    size_t subsystem_count;
+    STRUCT_SECTION_COUNT(zmk_rpc_custom_subsystem, &subsystem_count);
+
+    for (size_t i = 0; i < subsystem_count; i++) {
+        struct zmk_rpc_custom_subsystem *custom_subsys;
+        STRUCT_SECTION_GET(zmk_rpc_custom_subsystem, i, &custom_subsys);
+        if (strcmp(custom_subsys->identifier, identifier) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Payload encoding as it was done before: the encode callback sized the
+ * message and then serialized it, and the Studio encoder runs the callback
+ * once for its sizing pass and once for its write pass.
+ */
+static bool encode_payload_two_pass(const zmk_settings_Notification *msg,
+                                    uint8_t *buf, size_t len) {
+    for (int pass = 0; pass < 2; pass++) {
+        size_t size;
+        pb_ostream_t stream = pb_ostream_from_buffer(buf, len);
+        if (!pb_get_encoded_size(&size, zmk_settings_Notification_fields,
+                                 msg) ||
+            !pb_encode_varint(&stream, size) ||
+            !pb_encode(&stream, zmk_settings_Notification_fields, msg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Current payload encoding: serialize once, copy out on both passes
+static bool encode_payload_single_pass(const zmk_settings_Notification *msg,
+                                       uint8_t *buf, size_t len) {
+    uint8_t scratch[zmk_settings_Notification_size];
+    pb_ostream_t scratch_stream =
+        pb_ostream_from_buffer(scratch, sizeof(scratch));
+    if (!pb_encode(&scratch_stream, zmk_settings_Notification_fields, msg)) {
+        return false;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        pb_ostream_t stream = pb_ostream_from_buffer(buf, len);
+        if (!pb_encode_string(&stream, scratch,
+                              scratch_stream.bytes_written)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void notification_bench_run(struct k_work *work) {
+    volatile int sink;
+
+    bench_init();
+
+    BENCH_RUN("index_scan", sink = scan_subsystem_index("zmk__settings"));
+    BENCH_RUN("index_cached",
+              sink = zmk_rpc_custom_notifier_resolve(&zmk__settings_notifier));
+
+    zmk_settings_Notification notification =
+        zmk_settings_Notification_init_zero;
+    notification.which_notification_type =
+        zmk_settings_Notification_activity_settings_tag;
+    notification.notification_type.activity_settings.has_settings      = true;
+    notification.notification_type.activity_settings.settings.idle_ms  = 30000;
+    notification.notification_type.activity_settings.settings.sleep_ms = 900000;
+
+    uint8_t buf[zmk_settings_Notification_size + 8];
+    BENCH_RUN("encode_two_pass",
+              sink = encode_payload_two_pass(&notification, buf, sizeof(buf)));
+    BENCH_RUN("encode_single_pass", sink = encode_payload_single_pass(
+                                        &notification, buf, sizeof(buf)));
+
+    BENCH_RUN("notify", sink = zmk_rpc_custom_notify(
+                            &zmk__settings_notifier,
+                            zmk_settings_Notification_fields, &notification));
+
+    (void)sink;
+    LOG_INF("bench done");
+}
+
+static K_WORK_DELAYABLE_DEFINE(notification_bench_work, notification_bench_run);
+
+static int notification_bench_init(void) {
+    // Run after startup so the Studio subsystems are fully initialized
+    k_work_schedule(&notification_bench_work, K_MSEC(10));
+    return 0;
+}
+
+SYS_INIT(notification_bench_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Micro-benchmark for the relay wire codec.
+ *
+ * For every event in ZMK_SETTINGS_RELAY_EVENTS, compares the payload bytes
+ * sent over the split link when the event struct is copied as raw memory
+ * (the layout previously relayed) against its packed wire encoding, and the
+ * cycles spent encoding and decoding either way.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/events/settings_relay.h>
+
+#include "bench.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define RELAY_CODEC_BENCH(relay_id, type, source_field, dest_field,         \
+                          direction, kind, wire)                            \
+    do {                                                                    \
+        struct type ev;                                                     \
+        memset(&ev, 0x5a, sizeof(ev));                                      \
+        uint8_t raw[sizeof(ev)];                                            \
+        uint8_t packed[ZMK_SETTINGS_RELAY_WIRE_SIZE(wire)];                 \
+        LOG_INF("bench bytes " #type ": raw=%u packed=%u",                  \
+                (unsigned int)sizeof(raw), (unsigned int)sizeof(packed));   \
+        BENCH_RUN(#type "_raw_encode",                                      \
+                  (memcpy(raw, &ev, sizeof(ev)), sink = raw[0]));           \
+        BENCH_RUN(#type "_raw_decode",                                      \
+                  (memcpy(&ev, raw, sizeof(ev)), sink = raw[0]));           \
+        BENCH_RUN(#type "_packed_encode",                                   \
+                  sink = type##_relay_encode(&ev, packed));                 \
+        BENCH_RUN(#type "_packed_decode",                                   \
+                  sink = type##_relay_decode(&ev, packed, sizeof(packed))); \
+    } while (0);
+
+static void relay_codec_bench_run(struct k_work *work) {
+    volatile int sink;
+
+    bench_init();
+
+    ZMK_SETTINGS_RELAY_EVENTS(RELAY_CODEC_BENCH)
+
+    (void)sink;
+}
+
+static K_WORK_DELAYABLE_DEFINE(relay_codec_bench_work, relay_codec_bench_run);
+
+static int relay_codec_bench_init(void) {
+    // Run after the notification benchmark so their results do not interleave
+    k_work_schedule(&relay_codec_bench_work, K_MSEC(20));
+    return 0;
+}
+
+SYS_INIT(relay_codec_bench_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
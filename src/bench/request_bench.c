@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Benchmark of the settings RPC request path.
+ *
+ * Pre-encoded requests are run through each phase of a Studio call in a loop:
+ * decoding the payload, dispatching the decoded request to its handler,
+ * encoding the response, and all of them together as settings_rpc_handle_
+ * request() does. Notifications are measured through the queue and the
+ * direct send.
+ *
+ * Every phase runs on a fresh thread, so its stack is painted anew and the
+ * peak stack use is that of the phase alone. On native_posix, threads run on
+ * host stacks, so the stack figures are only meaningful on hardware.
+ *
+ * Requests that set settings are filled in with the settings in effect, so
+ * running them changes nothing and schedules no save.
+ *
+ * Results are logged as one JSON object per line, starting with {"bench":
+ * so they can be picked out of the log output:
+ *
+ * {"bench":"get_setting","phase":"decode","iterations":1000,
+ *  "cycles_per_op":312,"stack_peak_bytes":544}
+ */
+
+#include <pb_decode.h>
+#include <pb_encode.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity_settings.h>
+#include <zmk/settings/core.pb.h>
+
+#include "../studio/settings_rpc.h"
+#include "bench.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Responses are not bounded because of the streamed setting descriptors
+#define REQUEST_BENCH_RESPONSE_SIZE 256
+
+struct request_bench_case {
+    const char *name;
+    zmk_settings_Request request;
+    // Sets a request that changes settings to the settings in effect
+    void (*fill)(zmk_settings_Request *req);
+    // Filled in before the phases run
+    pb_byte_t payload[zmk_settings_Request_size];
+    size_t size;
+    zmk_settings_Response response;
+};
+
+struct request_bench_phase {
+    const char *name;
+    void (*run)(struct request_bench_case *bench_case);
+};
+
+static void fill_set_activity_settings(zmk_settings_Request *req) {
+    req->request_type.set_activity_settings.settings.idle_ms =
+        zmk_activity_get_idle_ms();
+    req->request_type.set_activity_settings.settings.sleep_ms =
+        zmk_activity_get_sleep_ms();
+}
+
+static void fill_set_setting(zmk_settings_Request *req) {
+    req->request_type.set_setting.setting.value = zmk_activity_get_idle_ms();
+}
+
+static struct request_bench_case cases[] = {
+    {
+        .name    = "get_activity_settings",
+        .request = {.which_request_type =
+                        zmk_settings_Request_get_activity_settings_tag},
+    },
+    {
+        .name    = "set_activity_settings",
+        .request = {.which_request_type =
+                        zmk_settings_Request_set_activity_settings_tag,
+                    .request_type.set_activity_settings =
+                        {
+                            .has_settings = true,
+                        }},
+        .fill    = fill_set_activity_settings,
+    },
+    {
+        .name    = "list_settings",
+        .request = {.which_request_type =
+                        zmk_settings_Request_list_settings_tag},
+    },
+    {
+        .name    = "get_setting",
+        .request = {.which_request_type = zmk_settings_Request_get_setting_tag,
+                    .request_type.get_setting = {.id = ZMK_SETTING_ID_IDLE_MS}},
+    },
+    {
+        .name    = "set_setting",
+        .request = {.which_request_type = zmk_settings_Request_set_setting_tag,
+                    .request_type.set_setting =
+                        {
+                            .has_setting = true,
+                            .setting     = {.id = ZMK_SETTING_ID_IDLE_MS},
+                        }},
+        .fill    = fill_set_setting,
+    },
+    {
+        .name    = "batch_get",
+        .request = {.which_request_type = zmk_settings_Request_batch_get_tag,
+                    .request_type.batch_get =
+                        {
+                            .ids_count = 2,
+                            .ids       = {ZMK_SETTING_ID_IDLE_MS,
+                                          ZMK_SETTING_ID_SLEEP_MS},
+                        }},
+    },
+};
+
+static void phase_decode(struct request_bench_case *bench_case) {
+    zmk_settings_Request req = zmk_settings_Request_init_zero;
+    pb_istream_t stream =
+        pb_istream_from_buffer(bench_case->payload, bench_case->size);
+    pb_decode(&stream, zmk_settings_Request_fields, &req);
+}
+
+static void phase_dispatch(struct request_bench_case *bench_case) {
+    zmk_settings_Response resp = zmk_settings_Response_init_zero;
+    settings_rpc_dispatch(&bench_case->request, &resp);
+}
+
+static void phase_encode(struct request_bench_case *bench_case) {
+    pb_byte_t buf[REQUEST_BENCH_RESPONSE_SIZE];
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, sizeof(buf));
+    pb_encode(&stream, zmk_settings_Response_fields, &bench_case->response);
+}
+
+// The whole call, as settings_rpc_handle_request() runs it
+static void phase_request(struct request_bench_case *bench_case) {
+    zmk_settings_Response resp = zmk_settings_Response_init_zero;
+    pb_byte_t buf[REQUEST_BENCH_RESPONSE_SIZE];
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, sizeof(buf));
+
+    settings_rpc_handle_payload(bench_case->payload, bench_case->size, &resp);
+    pb_encode(&stream, zmk_settings_Response_fields, &resp);
+}
+
+static const struct request_bench_phase request_phases[] = {
+    {.name = "decode", .run = phase_decode},
+    {.name = "dispatch", .run = phase_dispatch},
+    {.name = "encode", .run = phase_encode},
+    {.name = "request", .run = phase_request},
+};
+
+static zmk_settings_Notification notification = {
+    .which_notification_type = zmk_settings_Notification_activity_settings_tag,
+    .notification_type.activity_settings =
+        {
+            .has_settings = true,
+            .settings     = {.idle_ms = 30000, .sleep_ms = 900000},
+        },
+};
+
+static void phase_notification_encode(struct request_bench_case *bench_case) {
+    pb_byte_t buf[zmk_settings_Notification_size];
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, sizeof(buf));
+    pb_encode(&stream, zmk_settings_Notification_fields, &notification);
+}
+
+// Reports of the same device replace each other, so this takes one slot
+static void phase_notification_queue(struct request_bench_case *bench_case) {
+    settings_rpc_notify(&notification);
+}
+
+static void phase_notification_send(struct request_bench_case *bench_case) {
+    settings_rpc_send_notification(&notification);
+}
+
+static const struct request_bench_phase notification_phases[] = {
+    {.name = "encode", .run = phase_notification_encode},
+    {.name = "queue", .run = phase_notification_queue},
+    {.name = "send", .run = phase_notification_send},
+};
+
+static K_THREAD_STACK_DEFINE(phase_stack,
+                             CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_STACK_SIZE);
+static struct k_thread phase_thread;
+
+static void phase_entry(void *p1, void *p2, void *p3) {
+    struct request_bench_case *bench_case = p1;
+    const struct request_bench_phase *phase = p2;
+    uint64_t *cycles = p3;
+
+    bench_stamp_t start = bench_now();
+    for (int i = 0; i < CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS; i++) {
+        phase->run(bench_case);
+    }
+    *cycles = bench_cycles(start, bench_now());
+}
+
+#define REQUEST_BENCH_JSON                                  \
+    "{\"bench\":\"%s\",\"phase\":\"%s\",\"iterations\":%d," \
+    "\"cycles_per_op\":%u,\"stack_peak_bytes\":%u}"
+
+static void run_phase(const char *name, struct request_bench_case *bench_case,
+                      const struct request_bench_phase *phase) {
+    uint64_t cycles = 0;
+    size_t unused   = 0;
+
+    k_thread_create(&phase_thread, phase_stack,
+                    K_THREAD_STACK_SIZEOF(phase_stack), phase_entry,
+                    bench_case, (void *)phase, &cycles,
+                    k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+    k_thread_join(&phase_thread, K_FOREVER);
+    k_thread_stack_space_get(&phase_thread, &unused);
+
+    uint32_t cycles_per_op =
+        (uint32_t)(cycles / CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS);
+    uint32_t stack = (uint32_t)(K_THREAD_STACK_SIZEOF(phase_stack) - unused);
+    LOG_INF(REQUEST_BENCH_JSON, name, phase->name,
+            CONFIG_ZMK_SETTINGS_RPC_BENCHMARK_ITERATIONS, cycles_per_op, stack);
+}
+
+// Fill in and encode the request, and keep a response to encode
+static int prepare_case(struct request_bench_case *bench_case) {
+    if (bench_case->fill) {
+        bench_case->fill(&bench_case->request);
+    }
+
+    pb_ostream_t stream = pb_ostream_from_buffer(bench_case->payload,
+                                                 sizeof(bench_case->payload));
+    if (!pb_encode(&stream, zmk_settings_Request_fields,
+                   &bench_case->request)) {
+        LOG_ERR("Failed to encode %s request: %s", bench_case->name,
+                PB_GET_ERROR(&stream));
+        return -EINVAL;
+    }
+    bench_case->size = stream.bytes_written;
+
+    settings_rpc_dispatch(&bench_case->request, &bench_case->response);
+    if (bench_case->response.which_response_type ==
+        zmk_settings_Response_error_tag) {
+        LOG_ERR("Bench request %s failed: %s", bench_case->name,
+                bench_case->response.response_type.error.message);
+        return -EINVAL;
+    }
+    return 0;
+}
+
+static void request_bench_run(struct k_work *work) {
+    bench_init();
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+        if (prepare_case(&cases[i]) < 0) {
+            continue;
+        }
+        for (size_t j = 0; j < ARRAY_SIZE(request_phases); j++) {
+            run_phase(cases[i].name, &cases[i], &request_phases[j]);
+        }
+    }
+
+    for (size_t j = 0; j < ARRAY_SIZE(notification_phases); j++) {
+        run_phase("notification", NULL, &notification_phases[j]);
+    }
+    LOG_INF("bench requests done");
+}
+
+static K_WORK_DELAYABLE_DEFINE(request_bench_work, request_bench_run);
+
+static int request_bench_init(void) {
+    // Run after startup so the Studio subsystems are fully initialized
+    k_work_schedule(&request_bench_work, K_MSEC(10));
+    return 0;
+}
+
+SYS_INIT(request_bench_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -5,9 +5,12 @@
  */
 
 #include <zephyr/logging/log.h>
-#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_settings_changed.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_relay.h>
+#include <zmk/settings_rpc/stack_usage.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -22,16 +25,19 @@ static int activity_settings_changed_listener(const zmk_event_t *eh) {
     if (!ev) {
         return ZMK_EV_EVENT_BUBBLE;
     }
+    zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_EVENT);
 
-    // Only apply settings from relayed events (not self-originated)
-    if (ev->source != ZMK_RELAY_EVENT_SOURCE_SELF) {
+    // Only apply settings from relayed events (not self-originated) that are
+    // addressed to this device
+    if (ev->source != ZMK_RELAY_EVENT_SOURCE_SELF &&
+        zmk_settings_relay_addressed(ev->dest)) {
         LOG_DBG(
             "Applying relayed activity settings: idle=%d ms, sleep=%d ms from "
             "source %d",
             ev->idle_ms, ev->sleep_ms, ev->source);
 
-        zmk_activity_set_idle_ms(ev->idle_ms);
-        zmk_activity_set_sleep_ms(ev->sleep_ms);
+        // Kept without taking effect if this device has its own settings
+        zmk_activity_settings_apply_inherited(ev->idle_ms, ev->sleep_ms);
     }
 
     return ZMK_EV_EVENT_BUBBLE;
@@ -40,8 +46,10 @@ static int activity_settings_changed_listener(const zmk_event_t *eh) {
 ZMK_LISTENER(activity_settings_apply, activity_settings_changed_listener);
 ZMK_SUBSCRIPTION(activity_settings_apply, zmk_activity_settings_changed);
 
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && \
+    !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
 
 ZMK_RELAY_EVENT_HANDLE(zmk_activity_settings_changed, as, source);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_activity_settings_changed);
 
-#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
\ No newline at end of file
+#endif
\ No newline at end of file
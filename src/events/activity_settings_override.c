@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/logging/log.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_override.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_relay.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_EVENT_IMPL(zmk_activity_settings_override);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_activity_settings_override, aso,
+                                      source);
+#endif
+
+#else
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+ZMK_RELAY_EVENT_HANDLE(zmk_activity_settings_override, aso, source);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_activity_settings_override);
+#endif
+
+/**
+ * Event listener to apply or drop own activity settings (on peripherals)
+ */
+static int activity_settings_override_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_settings_override *ev =
+        as_zmk_activity_settings_override(eh);
+    if (!ev || ev->source == ZMK_RELAY_EVENT_SOURCE_SELF ||
+        !zmk_settings_relay_addressed(ev->dest)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    int rc;
+    if (ev->inherit) {
+        LOG_DBG("Inheriting the central's activity settings");
+        rc = zmk_activity_settings_drop_own();
+    } else {
+        LOG_DBG("Applying own activity settings: idle=%d ms, sleep=%d ms",
+                ev->idle_ms, ev->sleep_ms);
+        rc = zmk_activity_settings_apply_own(ev->idle_ms, ev->sleep_ms);
+    }
+    if (rc < 0) {
+        LOG_WRN("Failed to apply own activity settings: %d", rc);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_override, activity_settings_override_listener);
+ZMK_SUBSCRIPTION(activity_settings_override, zmk_activity_settings_override);
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
@@ -6,8 +6,13 @@
 
 #include <zephyr/logging/log.h>
 #include <zmk/activity.h>
+#include <zmk/activity_settings.h>
 #include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_override.h>
 #include <zmk/events/activity_settings_report.h>
+#include <zmk/events/setting_changed.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_relay.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -16,14 +21,20 @@ ZMK_EVENT_IMPL(zmk_activity_settings_report);
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
 
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
 // Event relay: settings report from peripheral to central
 ZMK_RELAY_EVENT_PERIPHERAL_TO_CENTRAL(zmk_activity_settings_report, srp,
                                       source);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_activity_settings_report);
+#endif
 
 #if !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
 
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
 // Handle settings request events (called on peripherals)
 ZMK_RELAY_EVENT_HANDLE(zmk_activity_settings_request, srq, );
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_activity_settings_request);
+#endif
 
 /**
  * Event listener to respond to settings requests (on peripherals)
@@ -42,6 +53,7 @@ static int activity_settings_request_listener(const zmk_event_t *eh) {
         .source = ZMK_RELAY_EVENT_SOURCE_SELF,  // Will be updated by relay with
                                                 // actual source
         .request_id = ev->request_id,
+        .own        = zmk_activity_settings_has_own(),
     };
 
     raise_zmk_activity_settings_report(report);
@@ -55,6 +67,43 @@ ZMK_LISTENER(activity_settings_request_handler,
              activity_settings_request_listener);
 ZMK_SUBSCRIPTION(activity_settings_request_handler,
                  zmk_activity_settings_request);
+
+/**
+ * Report changed settings to the central without being asked, so clients
+ * subscribed to changes see them and the central's cache holds what this
+ * peripheral applied. Changes of several settings in a row are reported
+ * once, with the values current when the work runs.
+ */
+static void settings_change_report_handler(struct k_work *work) {
+    struct zmk_activity_settings_report report = {
+        .idle_ms    = zmk_activity_get_idle_ms(),
+        .sleep_ms   = zmk_activity_get_sleep_ms(),
+        .source     = ZMK_RELAY_EVENT_SOURCE_SELF,
+        .request_id = 0,  // Unsolicited
+        .own        = zmk_activity_settings_has_own(),
+    };
+    raise_zmk_activity_settings_report(report);
+}
+
+static K_WORK_DEFINE(settings_change_report_work,
+                     settings_change_report_handler);
+
+static int setting_changed_report_listener(const zmk_event_t *eh) {
+    // Settings of its own, or inheriting the central's again, may leave the
+    // values as they were, but not whether they are this peripheral's own
+    const struct zmk_activity_settings_override *override =
+        as_zmk_activity_settings_override(eh);
+    if (as_zmk_setting_changed(eh) ||
+        (override && override->source != ZMK_RELAY_EVENT_SOURCE_SELF &&
+         zmk_settings_relay_addressed(override->dest))) {
+        k_work_submit(&settings_change_report_work);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(setting_changed_report, setting_changed_report_listener);
+ZMK_SUBSCRIPTION(setting_changed_report, zmk_setting_changed);
+ZMK_SUBSCRIPTION(setting_changed_report, zmk_activity_settings_override);
 #endif  // !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
 
 #endif  // IS_ENABLED(CONFIG_ZMK_SPLIT)
\ No newline at end of file
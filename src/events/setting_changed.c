@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/event_manager.h>
+#include <zmk/events/setting_changed.h>
+
+ZMK_EVENT_IMPL(zmk_setting_changed);
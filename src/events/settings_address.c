@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Addressing of relayed events to specific peripherals.
+ *
+ * The split relay sends every central event to all peripherals, and a
+ * peripheral does not know which source the central sees it as. A peripheral
+ * asks for it whenever the central checks its settings digest, which happens
+ * on every connection, and drops events that are addressed to other
+ * peripherals once it knows.
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_digest.h>
+#include <zmk/events/settings_relay.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_EVENT_IMPL(zmk_settings_address_request);
+ZMK_EVENT_IMPL(zmk_settings_address_assign);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && \
+    !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+ZMK_RELAY_EVENT_HANDLE(zmk_settings_address_assign, saa, );
+ZMK_RELAY_EVENT_PERIPHERAL_TO_CENTRAL(zmk_settings_address_request, saq,
+                                      source);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_settings_address_request);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_settings_address_assign);
+#endif
+
+static uint32_t nonce;
+// Source assigned by the central, 0 until known
+static atomic_t own_source;
+
+bool zmk_settings_relay_addressed(uint8_t dest) {
+    uint8_t source = (uint8_t)atomic_get(&own_source);
+    return dest == ZMK_SETTINGS_RELAY_DEST_ALL ||
+           (source != 0 && (dest & ZMK_SETTINGS_RELAY_DEST(source)));
+}
+
+/**
+ * Event listener to ask for the source of this peripheral whenever the
+ * central connects, since the source may change between connections.
+ */
+static int settings_address_digest_listener(const zmk_event_t *eh) {
+    if (as_zmk_settings_digest_request(eh)) {
+        raise_zmk_settings_address_request(
+            (struct zmk_settings_address_request){
+                .nonce  = nonce,
+                .source = ZMK_RELAY_EVENT_SOURCE_SELF,
+            });
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_address_request, settings_address_digest_listener);
+ZMK_SUBSCRIPTION(settings_address_request, zmk_settings_digest_request);
+
+/**
+ * Event listener to take the source assigned by the central
+ */
+static int settings_address_assign_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_address_assign *ev =
+        as_zmk_settings_address_assign(eh);
+    // Answers to other peripherals reach this one too
+    if (!ev || ev->nonce != nonce) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // Only the central knows how many peripherals there are; the address
+    // only has to fit the destination mask
+    if (ev->address == 0 || ev->address >= BITS_PER_BYTE) {
+        LOG_WRN("Ignoring invalid settings relay address %d", ev->address);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    atomic_set(&own_source, ev->address);
+    LOG_DBG("Settings relay address is %d", ev->address);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_address_assign, settings_address_assign_listener);
+ZMK_SUBSCRIPTION(settings_address_assign, zmk_settings_address_assign);
+
+static int settings_address_init(void) {
+    nonce = sys_rand32_get();
+    return 0;
+}
+
+SYS_INIT(settings_address_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#else
+
+bool zmk_settings_relay_addressed(uint8_t dest) { return true; }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_settings_address_assign, saa, );
+ZMK_RELAY_EVENT_HANDLE(zmk_settings_address_request, saq, source);
+#endif
+
+/**
+ * Event listener to tell a peripheral its source (on the central)
+ */
+static int settings_address_request_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_address_request *ev =
+        as_zmk_settings_address_request(eh);
+    if (!ev || ev->source == ZMK_RELAY_EVENT_SOURCE_SELF) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    raise_zmk_settings_address_assign((struct zmk_settings_address_assign){
+        .nonce   = ev->nonce,
+        .address = ev->source,
+    });
+    LOG_DBG("Assigned settings relay address %d", ev->source);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_address_assign, settings_address_request_listener);
+ZMK_SUBSCRIPTION(settings_address_assign, zmk_settings_address_request);
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && !central
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_digest.h>
+#include <zmk/events/settings_relay.h>
+#include <zmk/settings_rpc/setting.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_EVENT_IMPL(zmk_settings_digest_request);
+ZMK_EVENT_IMPL(zmk_settings_digest_report);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_settings_digest_request, sdq, );
+ZMK_RELAY_EVENT_HANDLE(zmk_settings_digest_report, sdp, source);
+#endif
+
+#else
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+ZMK_RELAY_EVENT_HANDLE(zmk_settings_digest_request, sdq, );
+ZMK_RELAY_EVENT_PERIPHERAL_TO_CENTRAL(zmk_settings_digest_report, sdp, source);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_settings_digest_request);
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_settings_digest_report);
+#endif
+
+/**
+ * Event listener to answer digest requests (on peripherals)
+ */
+static int settings_digest_request_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_digest_request *ev =
+        as_zmk_settings_digest_request(eh);
+    if (!ev) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    struct zmk_settings_digest_report report = {
+        .generation = zmk_settings_generation(),
+        .crc        = zmk_settings_digest(),
+        .source     = ZMK_RELAY_EVENT_SOURCE_SELF,
+        .seq        = ev->seq,
+    };
+    raise_zmk_settings_digest_report(report);
+    LOG_DBG("Reported settings digest 0x%08x (generation %u) for request %d",
+            report.crc, report.generation, ev->seq);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_digest_request_handler,
+             settings_digest_request_listener);
+ZMK_SUBSCRIPTION(settings_digest_request_handler, zmk_settings_digest_request);
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
@@ -0,0 +1,581 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Compact relay of the module's events between central and peripherals.
+ *
+ * Every event in ZMK_SETTINGS_RELAY_EVENTS is wrapped into a
+ * zmk_settings_relay envelope tagged with its 16-bit id. Only the envelope is
+ * registered with the split event relay, so the link carries one short type
+ * name for all of the module's events. The event is carried in its packed
+ * wire encoding rather than as raw struct memory, so no padding goes over the
+ * air. The receiver dispatches on the id by indexing a table instead of
+ * comparing type names.
+ *
+ * In reliable mode, the central numbers every state event it relays. Each
+ * peripheral acknowledges the sequence number once it has raised the event,
+ * and ignores repeated ones except for acknowledging them again. The central
+ * resends an event that is not acknowledged by every peripheral, with the
+ * timeout doubling after every attempt, and raises a
+ * zmk_settings_relay_delivery event with the outcome for each peripheral.
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_relay.h>
+#include <zmk/settings_rpc/relay_stats.h>
+#include <zmk/settings_rpc/stack_usage.h>
+#include <zmk/settings_rpc/util.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+ZMK_EVENT_IMPL(zmk_settings_relay);
+ZMK_EVENT_IMPL(zmk_settings_relay_delivery);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_settings_relay, srl, source);
+#else
+ZMK_RELAY_EVENT_PERIPHERAL_TO_CENTRAL(zmk_settings_relay, srl, source);
+#endif
+ZMK_RELAY_EVENT_HANDLE(zmk_settings_relay, srl, source);
+
+// The envelope is the only event this module relays in compact mode
+ZMK_SETTINGS_RELAY_ASSERT_FITS(zmk_settings_relay);
+
+/**
+ * Duplicate relay ids fail the build with a duplicate case value.
+ */
+static inline __unused void settings_relay_check_ids(uint16_t id) {
+    switch (id) {
+#define SETTINGS_RELAY_CASE(relay_id, type, source_field, dest_field, \
+                            direction, kind, wire)                    \
+    case relay_id:
+        ZMK_SETTINGS_RELAY_EVENTS(SETTINGS_RELAY_CASE)
+#undef SETTINGS_RELAY_CASE
+        break;
+    }
+}
+
+// Events without a source field are always raised locally
+#define SETTINGS_RELAY_IS_LOCAL(ev, source_field)                \
+    (COND_CODE_1(IS_EMPTY(source_field), (true),                 \
+                 ((ev)->source_field == ZMK_RELAY_EVENT_SOURCE_SELF)))
+
+#define SETTINGS_RELAY_SET_SOURCE(ev, source_field, src) \
+    COND_CODE_1(IS_EMPTY(source_field), (), ((ev).source_field = (src);))
+
+// Events without a destination field are for every peripheral
+#define SETTINGS_RELAY_GET_DEST(ev, dest_field)                       \
+    (COND_CODE_1(IS_EMPTY(dest_field), (ZMK_SETTINGS_RELAY_DEST_ALL), \
+                 ((ev)->dest_field)))
+
+#define SETTINGS_RELAY_SET_DEST(ev, dest_field, dst) \
+    COND_CODE_1(IS_EMPTY(dest_field), (), ((ev).dest_field = (dst);))
+
+// Hand an envelope to the split relay
+static void settings_relay_raise(struct zmk_settings_relay relay) {
+    int rc = raise_zmk_settings_relay(relay);
+    if (rc < 0) {
+        LOG_WRN("Split relay refused settings relay 0x%04x: %d",
+                sys_le16_to_cpu(relay.id), rc);
+    }
+    zmk_settings_relay_stats_sent(&relay, rc);
+}
+
+/**
+ * Envelope of a state event sent in reliable mode, kept until every
+ * peripheral has acknowledged it or it has been sent too many times.
+ */
+struct settings_relay_inflight {
+    uint32_t unacked;  // Bit per peripheral source yet to acknowledge
+    uint8_t attempts;
+    int64_t deadline;  // Uptime at which it is sent again
+    struct zmk_settings_relay relay;
+};
+
+/**
+ * Envelope of a state event waiting to be handed to the split relay.
+ * A newer event of the same type replaces it until it is sent.
+ */
+struct settings_relay_pending {
+    uint16_t id;
+    bool queued;
+    struct zmk_settings_relay relay;
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+    struct settings_relay_inflight inflight;
+#endif
+};
+
+#define SETTINGS_RELAY_PENDING_STATE(relay_id, type) \
+    static struct settings_relay_pending type##_pending = {.id = relay_id};
+#define SETTINGS_RELAY_PENDING_COMMAND(relay_id, type)
+
+#define SETTINGS_RELAY_DEFINE_PENDING(relay_id, type, source_field,      \
+                                      dest_field, direction, kind, wire) \
+    SETTINGS_RELAY_PENDING_##kind(relay_id, type)
+
+ZMK_SETTINGS_RELAY_EVENTS(SETTINGS_RELAY_DEFINE_PENDING)
+
+#define SETTINGS_RELAY_PENDING_ENTRY_STATE(type) &type##_pending,
+#define SETTINGS_RELAY_PENDING_ENTRY_COMMAND(type)
+
+#define SETTINGS_RELAY_PENDING_ENTRY(relay_id, type, source_field,      \
+                                     dest_field, direction, kind, wire) \
+    SETTINGS_RELAY_PENDING_ENTRY_##kind(type)
+
+static struct settings_relay_pending *const pending_relays[] = {
+    ZMK_SETTINGS_RELAY_EVENTS(SETTINGS_RELAY_PENDING_ENTRY)};
+
+static K_MUTEX_DEFINE(pending_lock);
+
+static void settings_relay_flush_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(settings_relay_flush_work,
+                               settings_relay_flush_work_handler);
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+/**
+ * Sequence number of the last reliable envelope. Seeded at boot, so a
+ * peripheral that still holds the number of an envelope sent before the
+ * central reset is unlikely to take the next one for a repeat.
+ */
+static uint8_t last_seq;
+
+// Peripherals that will not acknowledge an envelope
+struct settings_relay_failure {
+    uint16_t id;
+    uint32_t sources;
+    uint8_t attempts;
+};
+
+static void settings_relay_retransmit_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(settings_relay_retransmit_work,
+                               settings_relay_retransmit_handler);
+
+// Must be called with pending_lock held
+static uint8_t settings_relay_next_seq(void) {
+    // 0 marks envelopes that are not acknowledged
+    if (++last_seq == 0) {
+        last_seq++;
+    }
+    return last_seq;
+}
+
+// Time to wait for acknowledgements after the given attempt, doubling with
+// every attempt
+static int64_t settings_relay_ack_timeout(uint8_t attempts) {
+    return (int64_t)CONFIG_ZMK_SETTINGS_RPC_RELAY_ACK_TIMEOUT_MS
+           << (attempts - 1);
+}
+
+/**
+ * Schedule the retransmit work for the earliest deadline.
+ * Must be called with pending_lock held.
+ */
+static void settings_relay_schedule_retransmit(void) {
+    int64_t next = INT64_MAX;
+    for (size_t i = 0; i < ARRAY_SIZE(pending_relays); i++) {
+        if (pending_relays[i]->inflight.unacked) {
+            next = MIN(next, pending_relays[i]->inflight.deadline);
+        }
+    }
+
+    if (next == INT64_MAX) {
+        k_work_cancel_delayable(&settings_relay_retransmit_work);
+        return;
+    }
+    k_work_reschedule(&settings_relay_retransmit_work,
+                      K_MSEC(MAX(next - k_uptime_get(), 0)));
+}
+
+/**
+ * Number an envelope about to be sent and wait for its acknowledgements from
+ * the peripherals it is addressed to. It replaces the previous envelope of
+ * the same type, so peripherals that have not acknowledged that one get the
+ * newer value instead. Those the newer envelope is not for are set in
+ * @p cancelled. Must be called with pending_lock held.
+ */
+static void settings_relay_track(struct settings_relay_pending *pending,
+                                 struct zmk_settings_relay *relay,
+                                 struct settings_relay_failure *cancelled) {
+    uint32_t unacked = relay->dest & ZMK_SETTINGS_RPC_ALL_PERIPHERALS_MASK;
+
+    *cancelled = (struct settings_relay_failure){
+        .id       = pending->id,
+        .sources  = pending->inflight.unacked & ~unacked,
+        .attempts = pending->inflight.attempts,
+    };
+    relay->seq        = settings_relay_next_seq();
+    pending->inflight = (struct settings_relay_inflight){
+        .unacked  = unacked,
+        .attempts = 1,
+        .deadline = k_uptime_get() + settings_relay_ack_timeout(1),
+        .relay    = *relay,
+    };
+    settings_relay_schedule_retransmit();
+}
+
+static void settings_relay_raise_delivery(uint16_t id, uint8_t source,
+                                          uint8_t attempts, int status) {
+    raise_zmk_settings_relay_delivery((struct zmk_settings_relay_delivery){
+        .id       = id,
+        .source   = source,
+        .attempts = attempts,
+        .status   = status,
+    });
+}
+
+// Report the peripherals of @p failure that will not get the envelope
+static void settings_relay_report_failure(
+    const struct settings_relay_failure *failure, int status) {
+    zmk_settings_relay_stats_dropped(failure->id, failure->sources);
+    for (uint8_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (failure->sources & BIT(source)) {
+            LOG_WRN("Settings relay 0x%04x not acknowledged by %d after %d "
+                    "attempts: %d",
+                    failure->id, source, failure->attempts, status);
+            settings_relay_raise_delivery(failure->id, source,
+                                          failure->attempts, status);
+        }
+    }
+}
+
+static void settings_relay_retransmit_handler(struct k_work *work) {
+    struct zmk_settings_relay resend[ARRAY_SIZE(pending_relays)];
+    struct settings_relay_failure failed[ARRAY_SIZE(pending_relays)];
+    size_t resend_count = 0;
+    size_t failed_count = 0;
+
+    k_mutex_lock(&pending_lock, K_FOREVER);
+    int64_t now = k_uptime_get();
+    for (size_t i = 0; i < ARRAY_SIZE(pending_relays); i++) {
+        struct settings_relay_inflight *inflight = &pending_relays[i]->inflight;
+        if (!inflight->unacked || inflight->deadline > now) {
+            continue;
+        }
+
+        if (inflight->attempts > CONFIG_ZMK_SETTINGS_RPC_RELAY_RETRIES) {
+            failed[failed_count++] = (struct settings_relay_failure){
+                .id       = pending_relays[i]->id,
+                .sources  = inflight->unacked,
+                .attempts = inflight->attempts,
+            };
+            inflight->unacked = 0;
+            continue;
+        }
+
+        inflight->attempts++;
+        inflight->deadline =
+            now + settings_relay_ack_timeout(inflight->attempts);
+        resend[resend_count++] = inflight->relay;
+    }
+    settings_relay_schedule_retransmit();
+    k_mutex_unlock(&pending_lock);
+
+    for (size_t i = 0; i < resend_count; i++) {
+        LOG_DBG("Resending settings relay 0x%04x seq %d",
+                sys_le16_to_cpu(resend[i].id), resend[i].seq);
+        settings_relay_raise(resend[i]);
+    }
+
+    for (size_t i = 0; i < failed_count; i++) {
+        settings_relay_report_failure(&failed[i], -ETIMEDOUT);
+    }
+}
+
+// Count an acknowledgement received from a peripheral
+static void settings_relay_handle_ack(const struct zmk_settings_relay *relay) {
+    struct zmk_settings_relay_ack ack;
+    if (zmk_settings_relay_ack_relay_decode(&ack, relay->data, relay->len) <
+            0 ||
+        relay->source == 0 ||
+        relay->source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) {
+        LOG_WRN("Invalid settings relay ack from source %d", relay->source);
+        zmk_settings_relay_stats_discarded(relay);
+        return;
+    }
+
+    k_mutex_lock(&pending_lock, K_FOREVER);
+    uint8_t attempts = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(pending_relays); i++) {
+        struct settings_relay_inflight *inflight = &pending_relays[i]->inflight;
+        if (pending_relays[i]->id == ack.id &&
+            inflight->relay.seq == relay->seq &&
+            (inflight->unacked & BIT(relay->source))) {
+            inflight->unacked &= ~BIT(relay->source);
+            attempts = inflight->attempts;
+            settings_relay_schedule_retransmit();
+            break;
+        }
+    }
+    k_mutex_unlock(&pending_lock);
+
+    if (attempts == 0) {
+        // Repeated, or for an envelope replaced by a newer one
+        LOG_DBG("Ignored settings relay ack 0x%04x seq %d from %d", ack.id,
+                relay->seq, relay->source);
+        return;
+    }
+    settings_relay_raise_delivery(ack.id, relay->source, attempts, ack.status);
+}
+
+static int settings_relay_init(void) {
+    last_seq = (uint8_t)sys_rand32_get();
+    return 0;
+}
+
+SYS_INIT(settings_relay_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif
+
+// Hand a queued state event to the split relay
+static void settings_relay_flush_one(struct settings_relay_pending *pending) {
+    struct zmk_settings_relay relay;
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    struct settings_relay_failure cancelled = {0};
+#endif
+
+    k_mutex_lock(&pending_lock, K_FOREVER);
+    bool queued     = pending->queued;
+    relay           = pending->relay;
+    pending->queued = false;
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    if (queued) {
+        settings_relay_track(pending, &relay, &cancelled);
+    }
+#endif
+    k_mutex_unlock(&pending_lock);
+
+    if (queued) {
+        settings_relay_raise(relay);
+        zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_RELAY_SEND);
+    }
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    settings_relay_report_failure(&cancelled, -ECANCELED);
+#endif
+}
+
+// Hand all queued state events to the split relay
+static void settings_relay_flush(void) {
+    for (size_t i = 0; i < ARRAY_SIZE(pending_relays); i++) {
+        settings_relay_flush_one(pending_relays[i]);
+    }
+}
+
+static void settings_relay_flush_work_handler(struct k_work *work) {
+    settings_relay_flush();
+}
+
+/**
+ * Queue a state event, replacing the one of the same type that has not been
+ * sent yet. Scheduling does not push back a flush that is already pending,
+ * so a burst is held back for at most the coalescing window. A queued event
+ * for peripherals the new one is not addressed to is sent first instead.
+ */
+static void settings_relay_coalesce(struct settings_relay_pending *pending,
+                                    const struct zmk_settings_relay *relay) {
+    k_mutex_lock(&pending_lock, K_FOREVER);
+    bool narrowed = pending->queued && (pending->relay.dest & ~relay->dest);
+    k_mutex_unlock(&pending_lock);
+
+    if (narrowed) {
+        settings_relay_flush_one(pending);
+    }
+
+    k_mutex_lock(&pending_lock, K_FOREVER);
+    bool replaced     = pending->queued;
+    uint8_t prev_dest = pending->relay.dest;
+    pending->relay    = *relay;
+    pending->queued   = true;
+    k_mutex_unlock(&pending_lock);
+
+    if (replaced) {
+        LOG_DBG("Replaced queued settings relay 0x%04x", pending->id);
+        zmk_settings_relay_stats_dropped(pending->id, prev_dest);
+    }
+
+    k_work_schedule(&settings_relay_flush_work,
+                    K_MSEC(CONFIG_ZMK_SETTINGS_RPC_RELAY_COALESCE_MS));
+}
+
+#define SETTINGS_RELAY_SEND_STATE(type, relay) \
+    settings_relay_coalesce(&type##_pending, &(relay))
+
+// Commands flush queued state first so they are not sent ahead of it
+#define SETTINGS_RELAY_SEND_COMMAND(type, relay) \
+    do {                                         \
+        settings_relay_flush();                  \
+        settings_relay_raise(relay);             \
+    } while (0)
+
+/**
+ * Wrap locally raised events into an envelope for the split relay.
+ */
+#define SETTINGS_RELAY_SENDER(relay_id, type, source_field, dest_field, \
+                              kind)                                     \
+    static int type##_relay_listener(const zmk_event_t *eh) {           \
+        const struct type *ev = as_##type(eh);                          \
+        if (!ev || !SETTINGS_RELAY_IS_LOCAL(ev, source_field)) {        \
+            return ZMK_EV_EVENT_BUBBLE;                                 \
+        }                                                               \
+        struct zmk_settings_relay relay = {                             \
+            .id     = sys_cpu_to_le16(relay_id),                        \
+            .source = ZMK_RELAY_EVENT_SOURCE_SELF,                      \
+            .dest   = SETTINGS_RELAY_GET_DEST(ev, dest_field),          \
+        };                                                              \
+        relay.len = type##_relay_encode(ev, relay.data);                \
+        SETTINGS_RELAY_SEND_##kind(type, relay);                        \
+        return ZMK_EV_EVENT_BUBBLE;                                     \
+    }                                                                   \
+    ZMK_LISTENER(type##_relay, type##_relay_listener);                  \
+    ZMK_SUBSCRIPTION(type##_relay, type);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#define SETTINGS_RELAY_SENDER_CENTRAL_TO_PERIPHERAL SETTINGS_RELAY_SENDER
+#define SETTINGS_RELAY_SENDER_PERIPHERAL_TO_CENTRAL(...)
+#else
+#define SETTINGS_RELAY_SENDER_CENTRAL_TO_PERIPHERAL(...)
+#define SETTINGS_RELAY_SENDER_PERIPHERAL_TO_CENTRAL SETTINGS_RELAY_SENDER
+#endif
+
+#define SETTINGS_RELAY_DEFINE_SENDER(relay_id, type, source_field,      \
+                                     dest_field, direction, kind, wire) \
+    SETTINGS_RELAY_SENDER_##direction(relay_id, type, source_field,     \
+                                      dest_field, kind)
+
+ZMK_SETTINGS_RELAY_EVENTS(SETTINGS_RELAY_DEFINE_SENDER)
+
+/**
+ * Unwrap a received envelope and raise the original event with the source
+ * of the sender.
+ */
+#define SETTINGS_RELAY_RECEIVER(relay_id, type, source_field, dest_field,   \
+                                direction, kind, wire)                      \
+    static int type##_relay_raise(const struct zmk_settings_relay *relay) { \
+        struct type ev = {0};                                               \
+        int rc = type##_relay_decode(&ev, relay->data, relay->len);         \
+        if (rc < 0) {                                                       \
+            return rc;                                                      \
+        }                                                                   \
+        SETTINGS_RELAY_SET_SOURCE(ev, source_field, relay->source)          \
+        SETTINGS_RELAY_SET_DEST(ev, dest_field, relay->dest)                \
+        return raise_##type(ev);                                            \
+    }
+
+ZMK_SETTINGS_RELAY_EVENTS(SETTINGS_RELAY_RECEIVER)
+
+typedef int (*settings_relay_raise_t)(const struct zmk_settings_relay *relay);
+
+// Receivers indexed by relay id
+static const settings_relay_raise_t relay_receivers[] = {
+#define SETTINGS_RELAY_ENTRY(relay_id, type, source_field, dest_field, \
+                             direction, kind, wire)                    \
+    [relay_id] = type##_relay_raise,
+    ZMK_SETTINGS_RELAY_EVENTS(SETTINGS_RELAY_ENTRY)
+#undef SETTINGS_RELAY_ENTRY
+};
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+
+/**
+ * Sequence number last received per relay id. Only the central sends
+ * numbered envelopes, so this is the state of the only peer. Only touched
+ * from the split relay receive path.
+ */
+static uint8_t received_seq[ARRAY_SIZE(relay_receivers)];
+
+static void settings_relay_send_ack(const struct zmk_settings_relay *relay,
+                                    uint16_t id, int status) {
+    struct zmk_settings_relay_ack ack = {
+        .id     = id,
+        .status = (int8_t)status,
+    };
+    struct zmk_settings_relay reply = {
+        .id     = sys_cpu_to_le16(ZMK_SETTINGS_RELAY_ID_ACK),
+        .source = ZMK_RELAY_EVENT_SOURCE_SELF,
+        .seq    = relay->seq,
+    };
+    reply.len = zmk_settings_relay_ack_relay_encode(&ack, reply.data);
+    settings_relay_raise(reply);
+}
+
+// Raise a numbered envelope once, and acknowledge it every time
+static void settings_relay_receive_reliable(
+    const struct zmk_settings_relay *relay, uint16_t id) {
+    if (received_seq[id] == relay->seq) {
+        LOG_DBG("Repeated settings relay 0x%04x seq %d", id, relay->seq);
+        settings_relay_send_ack(relay, id, 0);
+        return;
+    }
+
+    int rc = relay_receivers[id](relay);
+    if (rc < 0) {
+        LOG_WRN("Failed to raise relayed event 0x%04x: %d", id, rc);
+        zmk_settings_relay_stats_discarded(relay);
+    }
+    received_seq[id] = relay->seq;
+    settings_relay_send_ack(relay, id, MIN(rc, 0));
+}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+
+static int settings_relay_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_relay *relay = as_zmk_settings_relay(eh);
+    if (!relay || relay->source == ZMK_RELAY_EVENT_SOURCE_SELF) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_RELAY_RECEIVE);
+    zmk_settings_relay_stats_received(relay);
+
+    uint16_t id = sys_le16_to_cpu(relay->id);
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    if (id == ZMK_SETTINGS_RELAY_ID_ACK) {
+        settings_relay_handle_ack(relay);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif
+    if (id >= ARRAY_SIZE(relay_receivers) || !relay_receivers[id]) {
+        LOG_WRN("Unknown settings relay id 0x%04x from source %d", id,
+                relay->source);
+        zmk_settings_relay_stats_discarded(relay);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // Envelopes reach every peripheral; only the addressed ones take them
+    if (!zmk_settings_relay_addressed(relay->dest)) {
+        LOG_DBG("Settings relay 0x%04x not addressed to this device", id);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+    if (relay->seq != 0) {
+        settings_relay_receive_reliable(relay, id);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif
+
+    int rc = relay_receivers[id](relay);
+    if (rc < 0) {
+        LOG_WRN("Failed to raise relayed event 0x%04x: %d", id, rc);
+        zmk_settings_relay_stats_discarded(relay);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_relay, settings_relay_listener);
+ZMK_SUBSCRIPTION(settings_relay, zmk_settings_relay);
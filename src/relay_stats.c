@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Statistics of the settings relay traffic on the split link.
+ *
+ * The central counts the envelopes it sends to and receives from each
+ * peripheral per relay id, along with their bytes, the envelopes it drops and
+ * those the split relay refuses. Bytes are the envelope header and the
+ * encoded event; the split transport's own framing is not included.
+ *
+ * The round-trip time of activity settings requests is taken from the
+ * request being raised to the report of each peripheral arriving, so it
+ * covers the split link in both directions and the peripheral's handling.
+ * Only the first report of a peripheral to a request is timed.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_report.h>
+#include <zmk/settings_rpc/relay_stats.h>
+#include <zmk/settings_rpc/util.h>
+
+// Requests timed at once; a new request reuses the oldest slot
+#define RTT_SLOTS 4
+
+struct peripheral_relay_stats {
+    struct zmk_settings_relay_event_stats events[ZMK_SETTINGS_RELAY_ID_COUNT];
+    struct zmk_settings_relay_rtt_stats rtt;
+};
+
+// Activity settings request waiting for reports
+struct rtt_slot {
+    uint8_t request_id;  // 0 if the slot is free
+    uint32_t start;
+    uint32_t unanswered;  // Bit per peripheral source yet to report
+};
+
+// Indexed by source - 1
+static struct peripheral_relay_stats
+    peripherals[ZMK_SETTINGS_RPC_PERIPHERAL_COUNT];
+static struct rtt_slot rtt_slots[RTT_SLOTS];
+static size_t next_rtt_slot;
+static K_MUTEX_DEFINE(stats_lock);
+
+static size_t relay_bytes(const struct zmk_settings_relay *relay) {
+    return offsetof(struct zmk_settings_relay, data) + relay->len;
+}
+
+// Must be called with stats_lock held
+static struct zmk_settings_relay_event_stats *event_stats(uint8_t source,
+                                                          uint16_t id) {
+    if (source == 0 || source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT ||
+        id >= ZMK_SETTINGS_RELAY_ID_COUNT) {
+        return NULL;
+    }
+    return &peripherals[source - 1].events[id];
+}
+
+void zmk_settings_relay_stats_sent(const struct zmk_settings_relay *relay,
+                                   int rc) {
+    uint16_t id = sys_le16_to_cpu(relay->id);
+
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    for (uint8_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        struct zmk_settings_relay_event_stats *stats = event_stats(source, id);
+        if (!stats) {
+            break;
+        }
+        if (rc < 0) {
+            stats->rejected++;
+        } else {
+            stats->sent++;
+            stats->sent_bytes += relay_bytes(relay);
+        }
+    }
+    k_mutex_unlock(&stats_lock);
+}
+
+void zmk_settings_relay_stats_received(const struct zmk_settings_relay *relay) {
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    struct zmk_settings_relay_event_stats *stats =
+        event_stats(relay->source, sys_le16_to_cpu(relay->id));
+    if (stats) {
+        stats->received++;
+        stats->received_bytes += relay_bytes(relay);
+    }
+    k_mutex_unlock(&stats_lock);
+}
+
+void zmk_settings_relay_stats_discarded(
+    const struct zmk_settings_relay *relay) {
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    struct zmk_settings_relay_event_stats *stats =
+        event_stats(relay->source, sys_le16_to_cpu(relay->id));
+    if (stats) {
+        stats->dropped++;
+    }
+    k_mutex_unlock(&stats_lock);
+}
+
+void zmk_settings_relay_stats_dropped(uint16_t id, uint32_t sources) {
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    for (uint8_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        struct zmk_settings_relay_event_stats *stats = event_stats(source, id);
+        if (stats && (sources & BIT(source))) {
+            stats->dropped++;
+        }
+    }
+    k_mutex_unlock(&stats_lock);
+}
+
+int zmk_settings_relay_stats_get(
+    uint8_t source,
+    struct zmk_settings_relay_event_stats events[ZMK_SETTINGS_RELAY_ID_COUNT],
+    struct zmk_settings_relay_rtt_stats *rtt) {
+    if (source == 0 || source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    memcpy(events, peripherals[source - 1].events,
+           sizeof(peripherals[source - 1].events));
+    *rtt = peripherals[source - 1].rtt;
+    k_mutex_unlock(&stats_lock);
+    return 0;
+}
+
+// Must be called with stats_lock held
+static void record_rtt(uint8_t source, uint32_t cycles) {
+    struct zmk_settings_relay_rtt_stats *rtt = &peripherals[source - 1].rtt;
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+
+    rtt->count++;
+    rtt->max_us = MAX(rtt->max_us, us);
+    rtt->buckets[zmk_settings_rpc_log2_bucket(
+        us, ZMK_SETTINGS_RELAY_RTT_BUCKETS)]++;
+}
+
+static int relay_stats_request_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_settings_request *ev =
+        as_zmk_activity_settings_request(eh);
+    if (!ev) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    rtt_slots[next_rtt_slot] = (struct rtt_slot){
+        .request_id = ev->request_id,
+        .start      = k_cycle_get_32(),
+        .unanswered = ZMK_SETTINGS_RPC_ALL_PERIPHERALS_MASK,
+    };
+    next_rtt_slot = (next_rtt_slot + 1) % ARRAY_SIZE(rtt_slots);
+    k_mutex_unlock(&stats_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+static int relay_stats_report_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_settings_report *ev =
+        as_zmk_activity_settings_report(eh);
+    if (!ev || ev->request_id == 0 || ev->source == 0 ||
+        ev->source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint32_t now = k_cycle_get_32();
+    k_mutex_lock(&stats_lock, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(rtt_slots); i++) {
+        struct rtt_slot *slot = &rtt_slots[i];
+        if (slot->request_id == ev->request_id &&
+            (slot->unanswered & BIT(ev->source))) {
+            slot->unanswered &= ~BIT(ev->source);
+            record_rtt(ev->source, now - slot->start);
+            break;
+        }
+    }
+    k_mutex_unlock(&stats_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(relay_stats_request, relay_stats_request_listener);
+ZMK_SUBSCRIPTION(relay_stats_request, zmk_activity_settings_request);
+ZMK_LISTENER(relay_stats_report, relay_stats_report_listener);
+ZMK_SUBSCRIPTION(relay_stats_report, zmk_activity_settings_report);
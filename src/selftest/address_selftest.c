@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Tests of relay addressing on a split peripheral.
+ *
+ * Envelopes of the central are raised as the split relay raises them on
+ * receipt, and the envelopes this peripheral hands to the split relay are
+ * watched as they are raised.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_relay.h>
+
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+// Relay ids of ZMK_SETTINGS_RELAY_EVENTS
+#define CHANGED_RELAY_ID        0x0001
+#define DIGEST_REQUEST_RELAY_ID 0x0004
+#define ADDRESS_ASSIGN_RELAY_ID 0x0007
+
+// Source of this peripheral as seen by the central, and of another one
+#define SELFTEST_ADDRESS       2
+#define SELFTEST_OTHER_ADDRESS 1
+
+static uint32_t requested_nonce;
+static atomic_t address_requests;
+static atomic_t acks_sent;
+static uint8_t central_seq;
+
+static int address_selftest_request_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_address_request *request =
+        as_zmk_settings_address_request(eh);
+    if (request && request->source == ZMK_RELAY_EVENT_SOURCE_SELF) {
+        requested_nonce = request->nonce;
+        atomic_inc(&address_requests);
+    }
+
+    const struct zmk_settings_relay *relay = as_zmk_settings_relay(eh);
+    if (relay && relay->source == ZMK_RELAY_EVENT_SOURCE_SELF &&
+        sys_le16_to_cpu(relay->id) == ZMK_SETTINGS_RELAY_ID_ACK) {
+        atomic_inc(&acks_sent);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(address_selftest, address_selftest_request_listener);
+ZMK_SUBSCRIPTION(address_selftest, zmk_settings_address_request);
+ZMK_SUBSCRIPTION(address_selftest, zmk_settings_relay);
+
+// Raise an envelope of the central, numbered as in reliable mode
+static void receive(uint16_t id, uint8_t dest, const uint8_t *data,
+                    uint8_t len) {
+    struct zmk_settings_relay relay = {
+        .id     = sys_cpu_to_le16(id),
+        .source = 0,
+        .seq    = ++central_seq,
+        .dest   = dest,
+        .len    = len,
+    };
+
+    memcpy(relay.data, data, len);
+    raise_zmk_settings_relay(relay);
+}
+
+static void receive_changed(uint8_t dest, uint32_t idle_ms,
+                            uint32_t sleep_ms) {
+    struct zmk_activity_settings_changed ev = {
+        .idle_ms  = idle_ms,
+        .sleep_ms = sleep_ms,
+    };
+    uint8_t data[ZMK_SETTINGS_RELAY_DATA_LEN];
+
+    receive(CHANGED_RELAY_ID, dest, data,
+            zmk_activity_settings_changed_relay_encode(&ev, data));
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(address_targeted) {
+    uint32_t idle_ms  = zmk_activity_get_idle_ms();
+    uint32_t sleep_ms = zmk_activity_get_sleep_ms();
+    uint8_t data[ZMK_SETTINGS_RELAY_DATA_LEN];
+
+    SELFTEST_CHECK(!zmk_activity_settings_has_own());
+
+    // The central checks the digest on connection, which asks for the
+    // address of this peripheral
+    atomic_val_t requests = atomic_get(&address_requests);
+    struct zmk_settings_digest_request digest = {.seq = 1};
+    receive(DIGEST_REQUEST_RELAY_ID, ZMK_SETTINGS_RELAY_DEST_ALL, data,
+            zmk_settings_digest_request_relay_encode(&digest, data));
+    SELFTEST_CHECK(atomic_get(&address_requests) == requests + 1);
+
+    // Answers to other peripherals are ignored
+    struct zmk_settings_address_assign assign = {
+        .nonce   = requested_nonce + 1,
+        .address = SELFTEST_OTHER_ADDRESS,
+    };
+    receive(ADDRESS_ASSIGN_RELAY_ID, ZMK_SETTINGS_RELAY_DEST_ALL, data,
+            zmk_settings_address_assign_relay_encode(&assign, data));
+    SELFTEST_CHECK(!zmk_settings_relay_addressed(
+        ZMK_SETTINGS_RELAY_DEST(SELFTEST_OTHER_ADDRESS)));
+
+    assign = (struct zmk_settings_address_assign){
+        .nonce   = requested_nonce,
+        .address = SELFTEST_ADDRESS,
+    };
+    receive(ADDRESS_ASSIGN_RELAY_ID, ZMK_SETTINGS_RELAY_DEST_ALL, data,
+            zmk_settings_address_assign_relay_encode(&assign, data));
+    SELFTEST_CHECK(zmk_settings_relay_addressed(
+        ZMK_SETTINGS_RELAY_DEST(SELFTEST_ADDRESS)));
+
+    // Settings for another peripheral are dropped without an ack
+    atomic_val_t acks = atomic_get(&acks_sent);
+    receive_changed(ZMK_SETTINGS_RELAY_DEST(SELFTEST_OTHER_ADDRESS),
+                    idle_ms / 2 + 1000, sleep_ms);
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == idle_ms);
+    SELFTEST_CHECK(atomic_get(&acks_sent) == acks);
+
+    // Settings for this peripheral are applied and acknowledged
+    receive_changed(ZMK_SETTINGS_RELAY_DEST(SELFTEST_ADDRESS),
+                    idle_ms / 2 + 1000, sleep_ms);
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == idle_ms / 2 + 1000);
+    SELFTEST_CHECK(zmk_activity_get_sleep_ms() == sleep_ms);
+    SELFTEST_CHECK(atomic_get(&acks_sent) == acks + 1);
+    return 0;
+}
+
+#endif  // !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
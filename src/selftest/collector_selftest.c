@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Tests of the GetAllActivitySettings collection on a split central.
+ *
+ * The reports of the peripherals are raised as the split relay raises them on
+ * receipt. Requests sent to the peripherals are counted to tell whether a
+ * query went over the split link.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_report.h>
+#include <zmk/events/settings_address.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+#include <zmk/events/settings_relay.h>
+#endif
+
+#include "../studio/settings_rpc.h"
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if ZMK_SETTINGS_RPC_PERIPHERAL_COUNT > 0
+
+// Time for a query the peripherals do not answer to time out
+#define SELFTEST_COLLECT_WAIT_MS \
+    (CONFIG_ZMK_SETTINGS_RPC_COLLECT_TIMEOUT_MS + 50)
+
+static atomic_t requests_sent;
+
+static int collector_selftest_request_listener(const zmk_event_t *eh) {
+    if (as_zmk_activity_settings_request(eh)) {
+        atomic_inc(&requests_sent);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(collector_selftest, collector_selftest_request_listener);
+ZMK_SUBSCRIPTION(collector_selftest, zmk_activity_settings_request);
+
+// Request id of the reports peripherals send when their settings change
+#define SELFTEST_UNSOLICITED 0
+
+// Answer a query as every peripheral
+static void report(uint8_t request_id) {
+    for (uint8_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        raise_zmk_activity_settings_report(
+            (struct zmk_activity_settings_report){
+                .idle_ms    = zmk_activity_get_idle_ms(),
+                .sleep_ms   = zmk_activity_get_sleep_ms(),
+                .source     = source,
+                .request_id = request_id,
+            });
+    }
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(collect_cache) {
+    uint8_t request_id;
+    bool joined;
+
+    SELFTEST_CHECK(activity_settings_collect(true, true, &request_id,
+                                             &joined) == 0);
+    report(request_id);
+
+    // Answered from the reports of the previous query
+    atomic_val_t sent = atomic_get(&requests_sent);
+    SELFTEST_CHECK(activity_settings_collect(true, false, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(!joined);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent);
+
+    // Forced queries go to the peripherals, and drop the cache of those that
+    // do not answer
+    SELFTEST_CHECK(activity_settings_collect(true, true, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 1);
+    k_msleep(SELFTEST_COLLECT_WAIT_MS);
+
+    SELFTEST_CHECK(activity_settings_collect(true, false, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 2);
+    report(request_id);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(collect_relayed) {
+    uint8_t request_id;
+    bool joined;
+
+    SELFTEST_CHECK(activity_settings_collect(true, true, &request_id,
+                                             &joined) == 0);
+    report(request_id);
+
+    // Settings relayed to the peripherals are not taken as applied
+    atomic_val_t sent = atomic_get(&requests_sent);
+    SELFTEST_CHECK(zmk_activity_set_timeouts_on(
+                       zmk_activity_get_idle_ms(), zmk_activity_get_sleep_ms(),
+                       false, ZMK_SETTINGS_RELAY_DEST_ALL) == 0);
+    SELFTEST_CHECK(activity_settings_collect(true, false, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 1);
+    report(request_id);
+
+    SELFTEST_CHECK(zmk_activity_settings_inherit_on(
+                       ZMK_SETTINGS_RELAY_DEST_ALL) == 0);
+
+    // Until the peripherals report the settings they applied
+    report(SELFTEST_UNSOLICITED);
+    SELFTEST_CHECK(activity_settings_collect(true, false, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 1);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(collect_single_flight) {
+    uint8_t first_id, request_id;
+    bool joined;
+
+    atomic_val_t sent = atomic_get(&requests_sent);
+    SELFTEST_CHECK(activity_settings_collect(true, true, &first_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(!joined);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 1);
+
+    // Joins the query in flight instead of asking again
+    SELFTEST_CHECK(activity_settings_collect(true, true, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(joined);
+    SELFTEST_CHECK(request_id == first_id);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 1);
+
+    // Queries of the other kind are separate
+    SELFTEST_CHECK(activity_settings_collect(false, true, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(!joined);
+    SELFTEST_CHECK(request_id != first_id);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 2);
+    report(request_id);
+    report(first_id);
+
+    // The query has completed, so the next one starts anew
+    SELFTEST_CHECK(activity_settings_collect(true, true, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(!joined);
+    SELFTEST_CHECK(request_id != first_id);
+    report(request_id);
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+ZMK_SETTINGS_SELFTEST_DEFINE(collect_undelivered) {
+    uint8_t request_id;
+    bool joined;
+
+    SELFTEST_CHECK(activity_settings_collect(true, true, &request_id,
+                                             &joined) == 0);
+    report(request_id);
+
+    // A relay the first peripheral never acknowledged drops its cache entry
+    atomic_val_t sent = atomic_get(&requests_sent);
+    raise_zmk_settings_relay_delivery((struct zmk_settings_relay_delivery){
+        .source   = 1,
+        .attempts = CONFIG_ZMK_SETTINGS_RPC_RELAY_RETRIES + 1,
+        .status   = -ETIMEDOUT,
+    });
+    SELFTEST_CHECK(activity_settings_collect(true, false, &request_id,
+                                             &joined) == 0);
+    SELFTEST_CHECK(atomic_get(&requests_sent) == sent + 1);
+    report(request_id);
+    return 0;
+}
+#endif
+
+#endif  // ZMK_SETTINGS_RPC_PERIPHERAL_COUNT > 0
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Tests of the reconciliation of relayed settings on a split central.
+ *
+ * A peripheral connecting is raised as the split transport raises it, and the
+ * digests of peripherals as the split relay raises them on receipt. The
+ * activity settings the central relays are watched as they are raised.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_changed.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_digest.h>
+#include <zmk/settings_rpc/setting.h>
+
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#include <zmk/events/split_peripheral_status_changed.h>
+
+#define SELFTEST_PERIPHERAL 1
+
+// Time for the digest request to go out after a peripheral connects
+#define SELFTEST_RECONCILE_WAIT_MS \
+    (CONFIG_ZMK_SETTINGS_RPC_RECONCILE_DELAY_MS + 20)
+
+static atomic_t digest_requests;
+static uint8_t digest_seq;
+static atomic_t changed_relayed;
+static uint8_t changed_dest;
+
+static int reconcile_selftest_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_digest_request *request =
+        as_zmk_settings_digest_request(eh);
+    if (request) {
+        digest_seq = request->seq;
+        atomic_inc(&digest_requests);
+    }
+
+    const struct zmk_activity_settings_changed *changed =
+        as_zmk_activity_settings_changed(eh);
+    if (changed && changed->source == ZMK_RELAY_EVENT_SOURCE_SELF) {
+        changed_dest = changed->dest;
+        atomic_inc(&changed_relayed);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(reconcile_selftest, reconcile_selftest_listener);
+ZMK_SUBSCRIPTION(reconcile_selftest, zmk_settings_digest_request);
+ZMK_SUBSCRIPTION(reconcile_selftest, zmk_activity_settings_changed);
+
+static void report_digest(uint8_t seq, uint32_t crc) {
+    raise_zmk_settings_digest_report((struct zmk_settings_digest_report){
+        .generation = 1,
+        .crc        = crc,
+        .source     = SELFTEST_PERIPHERAL,
+        .seq        = seq,
+    });
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(reconcile_targeted) {
+    atomic_val_t requests = atomic_get(&digest_requests);
+    raise_zmk_split_peripheral_status_changed(
+        (struct zmk_split_peripheral_status_changed){.connected = true});
+    k_msleep(SELFTEST_RECONCILE_WAIT_MS);
+    SELFTEST_CHECK(atomic_get(&digest_requests) == requests + 1);
+
+    // Peripherals in sync, and digests of earlier requests, relay nothing
+    atomic_val_t relayed = atomic_get(&changed_relayed);
+    uint32_t crc         = zmk_settings_digest();
+    report_digest(digest_seq, crc);
+    report_digest(digest_seq - 1, crc + 1);
+    SELFTEST_CHECK(atomic_get(&changed_relayed) == relayed);
+
+    // A peripheral out of sync gets the settings, and only it
+    report_digest(digest_seq, crc + 1);
+    SELFTEST_CHECK(atomic_get(&changed_relayed) == relayed + 1);
+    SELFTEST_CHECK(changed_dest ==
+                   ZMK_SETTINGS_RELAY_DEST(SELFTEST_PERIPHERAL));
+    return 0;
+}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && central
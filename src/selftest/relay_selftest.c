@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Tests of the reliable settings relay on a split central.
+ *
+ * Envelopes handed to the split relay are watched as they are raised, and
+ * acknowledgements of peripheral 1 are raised as the split relay raises them
+ * on receipt.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_relay.h>
+
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+// Relay id of zmk_activity_settings_changed in ZMK_SETTINGS_RELAY_EVENTS
+#define CHANGED_RELAY_ID 0x0001
+
+#define SELFTEST_PERIPHERAL 1
+
+// Time for a queued envelope to be sent
+#define RELAY_FLUSH_MS (CONFIG_ZMK_SETTINGS_RPC_RELAY_COALESCE_MS + 20)
+
+// Time for all attempts of an envelope to time out, doubling every attempt
+#define RELAY_ACK_WAIT_MS                           \
+    (CONFIG_ZMK_SETTINGS_RPC_RELAY_ACK_TIMEOUT_MS * \
+     ((2 << CONFIG_ZMK_SETTINGS_RPC_RELAY_RETRIES) - 1))
+
+// Time for an envelope to be sent and run its course
+#define RELAY_SETTLE_MS (RELAY_FLUSH_MS + RELAY_ACK_WAIT_MS)
+
+static atomic_t changed_sent;
+static uint8_t changed_seq;
+static atomic_t deliveries;
+static struct zmk_settings_relay_delivery last_delivery;
+
+static int relay_selftest_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_relay *relay = as_zmk_settings_relay(eh);
+    if (relay && relay->source == ZMK_RELAY_EVENT_SOURCE_SELF &&
+        sys_le16_to_cpu(relay->id) == CHANGED_RELAY_ID) {
+        changed_seq = relay->seq;
+        atomic_inc(&changed_sent);
+    }
+
+    const struct zmk_settings_relay_delivery *delivery =
+        as_zmk_settings_relay_delivery(eh);
+    if (delivery) {
+        last_delivery = *delivery;
+        atomic_inc(&deliveries);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(relay_selftest, relay_selftest_listener);
+ZMK_SUBSCRIPTION(relay_selftest, zmk_settings_relay);
+ZMK_SUBSCRIPTION(relay_selftest, zmk_settings_relay_delivery);
+
+static void ack(uint8_t seq) {
+    struct zmk_settings_relay_ack payload = {.id = CHANGED_RELAY_ID};
+
+    struct zmk_settings_relay relay = {
+        .id     = sys_cpu_to_le16(ZMK_SETTINGS_RELAY_ID_ACK),
+        .source = SELFTEST_PERIPHERAL,
+        .seq    = seq,
+    };
+
+    relay.len = zmk_settings_relay_ack_relay_encode(&payload, relay.data);
+    raise_zmk_settings_relay(relay);
+}
+
+// Change the central's timeouts, which relays them, and wait for the envelope
+static int change_and_send(void) {
+    // Let envelopes of earlier tests run their course
+    k_msleep(RELAY_SETTLE_MS);
+
+    atomic_val_t sent = atomic_get(&changed_sent);
+    SELFTEST_CHECK(zmk_activity_set_timeouts(
+                       zmk_activity_get_idle_ms() / 2 + 1000,
+                       zmk_activity_get_sleep_ms()) == 0);
+    k_msleep(RELAY_FLUSH_MS);
+    SELFTEST_CHECK(atomic_get(&changed_sent) == sent + 1);
+    SELFTEST_CHECK(changed_seq != 0);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(relay_reliable_ack) {
+    int rc = change_and_send();
+    if (rc < 0) {
+        return rc;
+    }
+
+    atomic_val_t sent      = atomic_get(&changed_sent);
+    atomic_val_t delivered = atomic_get(&deliveries);
+    ack(changed_seq);
+    SELFTEST_CHECK(atomic_get(&deliveries) == delivered + 1);
+    SELFTEST_CHECK(last_delivery.id == CHANGED_RELAY_ID);
+    SELFTEST_CHECK(last_delivery.source == SELFTEST_PERIPHERAL);
+    SELFTEST_CHECK(last_delivery.attempts == 1);
+    SELFTEST_CHECK(last_delivery.status == 0);
+
+    // Acknowledged envelopes are not sent again, and repeated acks ignored
+    ack(changed_seq);
+    k_msleep(RELAY_SETTLE_MS);
+    SELFTEST_CHECK(atomic_get(&changed_sent) == sent);
+    SELFTEST_CHECK(atomic_get(&deliveries) == delivered + 1);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(relay_reliable_timeout) {
+    int rc = change_and_send();
+    if (rc < 0) {
+        return rc;
+    }
+
+    atomic_val_t sent      = atomic_get(&changed_sent);
+    atomic_val_t delivered = atomic_get(&deliveries);
+    k_msleep(RELAY_SETTLE_MS);
+    SELFTEST_CHECK(atomic_get(&changed_sent) ==
+                   sent + CONFIG_ZMK_SETTINGS_RPC_RELAY_RETRIES);
+    SELFTEST_CHECK(atomic_get(&deliveries) == delivered + 1);
+    SELFTEST_CHECK(last_delivery.source == SELFTEST_PERIPHERAL);
+    SELFTEST_CHECK(last_delivery.attempts ==
+                   CONFIG_ZMK_SETTINGS_RPC_RELAY_RETRIES + 1);
+    SELFTEST_CHECK(last_delivery.status == -ETIMEDOUT);
+    return 0;
+}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && central
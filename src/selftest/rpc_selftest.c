@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Tests of the settings RPCs, with requests dispatched as Studio calls are.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_report.h>
+#include <zmk/settings/core.pb.h>
+#include <zmk/settings_rpc/setting.h>
+#include <zmk/studio/core.h>
+#include <zmk/studio/custom.h>
+
+#include "../studio/settings_rpc.h"
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Time for a change to be pushed to a subscribed client
+#define SELFTEST_PUSH_WAIT_MS (CONFIG_ZMK_SETTINGS_RPC_PUSH_INTERVAL_MS + 50)
+
+static atomic_t notifications;
+
+static int rpc_selftest_notification_listener(const zmk_event_t *eh) {
+    if (as_zmk_studio_custom_notification(eh)) {
+        atomic_inc(&notifications);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(rpc_selftest, rpc_selftest_notification_listener);
+ZMK_SUBSCRIPTION(rpc_selftest, zmk_studio_custom_notification);
+
+// Dispatch @p req and return the type of its response
+static pb_size_t dispatch(const zmk_settings_Request *req,
+                          uint32_t *generation) {
+    zmk_settings_Response resp = zmk_settings_Response_init_zero;
+
+    settings_rpc_dispatch(req, &resp);
+    if (generation) {
+        *generation = resp.generation;
+    }
+    return resp.which_response_type;
+}
+
+static pb_size_t get_activity_settings(uint32_t if_generation,
+                                       uint32_t *generation) {
+    zmk_settings_Request req = zmk_settings_Request_init_zero;
+
+    req.which_request_type = zmk_settings_Request_get_activity_settings_tag;
+
+    req.request_type.get_activity_settings.if_generation = if_generation;
+    return dispatch(&req, generation);
+}
+
+static pb_size_t batch_get(uint32_t if_generation) {
+    zmk_settings_Request req = zmk_settings_Request_init_zero;
+
+    req.which_request_type = zmk_settings_Request_batch_get_tag;
+
+    req.request_type.batch_get.ids_count     = 1;
+    req.request_type.batch_get.ids[0]        = ZMK_SETTING_ID_IDLE_MS;
+    req.request_type.batch_get.if_generation = if_generation;
+    return dispatch(&req, NULL);
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(rpc_not_modified) {
+    uint32_t idle_ms  = zmk_activity_get_idle_ms();
+    uint32_t sleep_ms = zmk_activity_get_sleep_ms();
+    uint32_t generation, current;
+
+    SELFTEST_CHECK(get_activity_settings(0, &generation) ==
+                   zmk_settings_Response_get_activity_settings_tag);
+    SELFTEST_CHECK(generation != 0);
+    SELFTEST_CHECK(get_activity_settings(generation, &current) ==
+                   zmk_settings_Response_not_modified_tag);
+    SELFTEST_CHECK(current == generation);
+    SELFTEST_CHECK(batch_get(generation) ==
+                   zmk_settings_Response_not_modified_tag);
+
+    // Applying the settings in effect again changes nothing
+    SELFTEST_CHECK(zmk_activity_set_timeouts(idle_ms, sleep_ms) == 0);
+    SELFTEST_CHECK(get_activity_settings(generation, &current) ==
+                   zmk_settings_Response_not_modified_tag);
+
+    SELFTEST_CHECK(zmk_activity_set_timeouts(idle_ms / 2 + 1000, sleep_ms) ==
+                   0);
+    SELFTEST_CHECK(get_activity_settings(generation, &current) ==
+                   zmk_settings_Response_get_activity_settings_tag);
+    SELFTEST_CHECK(current != generation && current != 0);
+    SELFTEST_CHECK(batch_get(generation) ==
+                   zmk_settings_Response_batch_get_tag);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(rpc_set_invalid_pair) {
+    uint32_t idle_ms         = zmk_activity_get_idle_ms();
+    uint32_t sleep_ms        = zmk_activity_get_sleep_ms();
+    zmk_settings_Request req = zmk_settings_Request_init_zero;
+
+    req.which_request_type = zmk_settings_Request_set_activity_settings_tag;
+
+    req.request_type.set_activity_settings.has_settings      = true;
+    req.request_type.set_activity_settings.settings.idle_ms  = 60000;
+    req.request_type.set_activity_settings.settings.sleep_ms = 30000;
+    SELFTEST_CHECK(dispatch(&req, NULL) == zmk_settings_Response_error_tag);
+
+    zmk_settings_Request batch = zmk_settings_Request_init_zero;
+    zmk_settings_Response resp = zmk_settings_Response_init_zero;
+
+    batch.which_request_type = zmk_settings_Request_batch_set_tag;
+
+    batch.request_type.batch_set.settings[0] = (zmk_settings_Setting){
+        .id    = ZMK_SETTING_ID_IDLE_MS,
+        .value = 60000,
+    };
+    batch.request_type.batch_set.settings[1] = (zmk_settings_Setting){
+        .id    = ZMK_SETTING_ID_SLEEP_MS,
+        .value = 30000,
+    };
+    batch.request_type.batch_set.settings_count = 2;
+    settings_rpc_dispatch(&batch, &resp);
+    SELFTEST_CHECK(resp.which_response_type ==
+                   zmk_settings_Response_batch_set_tag);
+    SELFTEST_CHECK(!resp.response_type.batch_set.success);
+
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == idle_ms);
+    SELFTEST_CHECK(zmk_activity_get_sleep_ms() == sleep_ms);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(rpc_set_unchanged) {
+    uint32_t generation, current;
+    zmk_settings_Request req = zmk_settings_Request_init_zero;
+
+    // Peripherals report that they inherit the central's timeouts
+    for (uint8_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        raise_zmk_activity_settings_report(
+            (struct zmk_activity_settings_report){
+                .idle_ms  = zmk_activity_get_idle_ms(),
+                .sleep_ms = zmk_activity_get_sleep_ms(),
+                .source   = source,
+            });
+    }
+
+    req.which_request_type = zmk_settings_Request_set_activity_settings_tag;
+
+    req.request_type.set_activity_settings.has_settings = true;
+    req.request_type.set_activity_settings.settings.idle_ms =
+        zmk_activity_get_idle_ms();
+    req.request_type.set_activity_settings.settings.sleep_ms =
+        zmk_activity_get_sleep_ms();
+    SELFTEST_CHECK(get_activity_settings(0, &generation) ==
+                   zmk_settings_Response_get_activity_settings_tag);
+
+    // Setting the timeouts in effect again changes nothing
+    SELFTEST_CHECK(dispatch(&req, NULL) ==
+                   zmk_settings_Response_set_activity_settings_tag);
+    SELFTEST_CHECK(get_activity_settings(generation, &current) ==
+                   zmk_settings_Response_not_modified_tag);
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(rpc_subscription_session_end) {
+    uint32_t idle_ms         = zmk_activity_get_idle_ms();
+    uint32_t sleep_ms        = zmk_activity_get_sleep_ms();
+    zmk_settings_Request req = zmk_settings_Request_init_zero;
+
+    req.which_request_type = zmk_settings_Request_subscribe_tag;
+    zmk_studio_core_unlock();
+    SELFTEST_CHECK(dispatch(&req, NULL) == zmk_settings_Response_subscribe_tag);
+
+    atomic_val_t sent = atomic_get(&notifications);
+    SELFTEST_CHECK(zmk_activity_set_timeouts(idle_ms / 2 + 1000, sleep_ms) ==
+                   0);
+    k_msleep(SELFTEST_PUSH_WAIT_MS);
+    SELFTEST_CHECK(atomic_get(&notifications) > sent);
+
+    // Studio locks when the client disconnects, which ends its subscription
+    zmk_studio_core_lock();
+    sent = atomic_get(&notifications);
+    SELFTEST_CHECK(zmk_activity_set_timeouts(idle_ms, sleep_ms) == 0);
+    k_msleep(SELFTEST_PUSH_WAIT_MS);
+    SELFTEST_CHECK(atomic_get(&notifications) == sent);
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Runner of the settings RPC behavior tests.
+ *
+ * The tests start once the application is up and the split relay and Studio
+ * handlers are registered, and run on their own thread so they can wait for
+ * the module's work items. "selftest done" is logged after the last one.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Delay after boot before the first test
+#define SELFTEST_START_DELAY_MS 100
+
+static void selftest_run(void *p1, void *p2, void *p3) {
+    STRUCT_SECTION_FOREACH(zmk_settings_selftest, test) {
+        uint32_t idle_ms  = zmk_activity_get_idle_ms();
+        uint32_t sleep_ms = zmk_activity_get_sleep_ms();
+
+        int rc = test->run();
+        if (rc == 0) {
+            LOG_INF("selftest %s: ok", test->name);
+        } else {
+            LOG_ERR("selftest %s: FAIL (%d)", test->name, rc);
+        }
+
+        // Applied on this device only, so nothing is relayed
+        zmk_activity_settings_apply(idle_ms, sleep_ms);
+    }
+    LOG_INF("selftest done");
+}
+
+K_THREAD_DEFINE(settings_selftest, CONFIG_ZMK_SETTINGS_RPC_SELFTEST_STACK_SIZE,
+                selftest_run, NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, SELFTEST_START_DELAY_MS);
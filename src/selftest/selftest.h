@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/iterable_sections.h>
+
+/**
+ * Behavior tests of the settings RPC module, run on the device shortly after
+ * boot. Tests run one at a time in the order of their names, on a thread of
+ * their own, so they may sleep while work items and timeouts run. The
+ * activity timeouts are restored after every test.
+ *
+ * The outcome of every test is logged as "selftest <name>: ok" or
+ * "selftest <name>: FAIL", for the zmk-test snapshots to pick out of the log.
+ */
+struct zmk_settings_selftest {
+    const char *name;
+    // 0 if the test passed
+    int (*run)(void);
+};
+
+/**
+ * Define a test, followed by its body:
+ *
+ * @code
+ * ZMK_SETTINGS_SELFTEST_DEFINE(batch_rollback) {
+ *     SELFTEST_CHECK(zmk_setting_set_batch(values, 2) < 0);
+ *     return 0;
+ * }
+ * @endcode
+ */
+#define ZMK_SETTINGS_SELFTEST_DEFINE(_name)                          \
+    static int _name##_selftest(void);                               \
+    STRUCT_SECTION_ITERABLE(zmk_settings_selftest,                   \
+                            zmk_settings_selftest_##_name) = {       \
+        .name = #_name,                                              \
+        .run  = _name##_selftest,                                    \
+    };                                                               \
+    static int _name##_selftest(void)
+
+/** Fail the calling test if @p cond does not hold, logging the condition. */
+#define SELFTEST_CHECK(cond)                                  \
+    do {                                                      \
+        if (!(cond)) {                                        \
+            LOG_ERR("selftest check failed: %s", #cond);      \
+            return -EIO;                                      \
+        }                                                     \
+    } while (0)
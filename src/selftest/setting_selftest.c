@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Tests of the settings registry: batches are applied all or nothing, and
+ * the activity timeouts are only applied as a valid pair.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity.h>
+#include <zmk/activity_settings.h>
+#include <zmk/settings_rpc/setting.h>
+
+#include "selftest.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Outside the range of the module's own settings
+#define SELFTEST_SETTING_ID CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID
+
+// Setting of its own group, whose setter fails on demand
+static uint32_t flaky_value;
+static bool flaky_fail;
+static int flaky_calls;
+
+static uint32_t get_flaky(void) { return flaky_value; }
+
+static int set_flaky(uint32_t value) {
+    flaky_calls++;
+    if (flaky_fail) {
+        return -EIO;
+    }
+    flaky_value = value;
+    return 0;
+}
+
+ZMK_SETTING_DEFINE(selftest_flaky, SELFTEST_SETTING_ID,
+                   .type = ZMK_SETTING_TYPE_BOOL,
+                   .max  = 1,
+                   .get  = get_flaky,
+                   .set  = set_flaky);
+
+// Idle timeout that differs from the current one and pairs with its sleep
+static uint32_t other_idle_ms(void) {
+    return zmk_activity_get_idle_ms() / 2 + 1000;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(activity_invalid_pair) {
+    uint32_t idle_ms  = zmk_activity_get_idle_ms();
+    uint32_t sleep_ms = zmk_activity_get_sleep_ms();
+
+    // Sleeping before going idle is rejected as a whole
+    SELFTEST_CHECK(zmk_activity_settings_apply(60000, 30000) == -EINVAL);
+    SELFTEST_CHECK(zmk_activity_set_timeouts(60000, 30000) == -EINVAL);
+
+    const struct zmk_setting_value pair[] = {
+        {.id = ZMK_SETTING_ID_IDLE_MS, .value = 60000},
+        {.id = ZMK_SETTING_ID_SLEEP_MS, .value = 30000},
+    };
+    SELFTEST_CHECK(zmk_setting_set_batch(pair, ARRAY_SIZE(pair)) == -EINVAL);
+
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == idle_ms);
+    SELFTEST_CHECK(zmk_activity_get_sleep_ms() == sleep_ms);
+
+    // Either timeout may be disabled on its own
+    SELFTEST_CHECK(zmk_activity_settings_valid(60000, 0));
+    SELFTEST_CHECK(zmk_activity_settings_valid(0, 30000));
+    return 0;
+}
+
+ZMK_SETTINGS_SELFTEST_DEFINE(batch_rollback) {
+    uint32_t idle_ms     = zmk_activity_get_idle_ms();
+    uint32_t new_idle_ms = other_idle_ms();
+
+    const struct zmk_setting_value values[] = {
+        {.id = ZMK_SETTING_ID_IDLE_MS, .value = new_idle_ms},
+        {.id = SELFTEST_SETTING_ID, .value = 1},
+    };
+
+    // The second group fails after the first one has been applied
+    flaky_value = 0;
+    flaky_fail  = true;
+    flaky_calls = 0;
+    SELFTEST_CHECK(zmk_setting_set_batch(values, ARRAY_SIZE(values)) == -EIO);
+    SELFTEST_CHECK(flaky_calls == 1);
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == idle_ms);
+    SELFTEST_CHECK(flaky_value == 0);
+
+    // Nothing is applied if a value is out of bounds
+    const struct zmk_setting_value out_of_range[] = {
+        {.id = ZMK_SETTING_ID_IDLE_MS, .value = new_idle_ms},
+        {.id = SELFTEST_SETTING_ID, .value = 2},
+    };
+    flaky_fail = false;
+    SELFTEST_CHECK(zmk_setting_set_batch(out_of_range,
+                                         ARRAY_SIZE(out_of_range)) == -ERANGE);
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == idle_ms);
+
+    SELFTEST_CHECK(zmk_setting_set_batch(values, ARRAY_SIZE(values)) == 0);
+    SELFTEST_CHECK(zmk_activity_get_idle_ms() == new_idle_ms);
+    SELFTEST_CHECK(flaky_value == 1);
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zmk/event_manager.h>
+#include <zmk/settings_rpc/setting.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/events/split_peripheral_status_changed.h>
+#endif
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+static atomic_t generation;
+
+// Registered settings indexed by id, filled in once at boot
+static const struct zmk_setting
+    *settings_by_id[CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID + 1];
+
+const struct zmk_setting *zmk_setting_find(uint32_t id) {
+    if (id >= ARRAY_SIZE(settings_by_id)) {
+        return NULL;
+    }
+    return settings_by_id[id];
+}
+
+int zmk_setting_get(uint32_t id, uint32_t *value) {
+    const struct zmk_setting *setting = zmk_setting_find(id);
+    if (!setting) {
+        return -ENOENT;
+    }
+    *value = setting->get();
+    return 0;
+}
+
+// Apply a setting, or its whole group, with the values indexed by id
+static int apply_setting(const struct zmk_setting *setting,
+                         const uint32_t *values) {
+    if (setting->group) {
+        return setting->group->apply(values);
+    }
+    return setting->set(values[setting->id]);
+}
+
+// Whether a setting of the same group appears earlier in the batch
+static bool group_seen(const struct zmk_setting_value *values, size_t index,
+                       const struct zmk_setting_group *group) {
+    for (size_t i = 0; i < index; i++) {
+        if (zmk_setting_find(values[i].id)->group == group) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Restore the settings of @p values applied before the one at @p failed
+static void rollback_batch(const struct zmk_setting_value *values,
+                           size_t failed, const uint32_t *previous) {
+    for (size_t i = 0; i < failed; i++) {
+        const struct zmk_setting *setting = zmk_setting_find(values[i].id);
+        if (setting->group && group_seen(values, i, setting->group)) {
+            continue;
+        }
+
+        int rc = apply_setting(setting, previous);
+        if (rc < 0) {
+            LOG_ERR("Failed to restore setting %s: %d", setting->name, rc);
+        }
+    }
+}
+
+int zmk_setting_set_batch(const struct zmk_setting_value *values,
+                          size_t count) {
+    uint32_t proposed[ARRAY_SIZE(settings_by_id)] = {0};
+    uint32_t previous[ARRAY_SIZE(settings_by_id)] = {0};
+    bool changed[ARRAY_SIZE(settings_by_id)]      = {false};
+
+    for (size_t i = 0; i < count; i++) {
+        const struct zmk_setting *setting = zmk_setting_find(values[i].id);
+        if (!setting) {
+            LOG_WRN("Unknown setting id %d", values[i].id);
+            return -ENOENT;
+        }
+        if (changed[setting->id]) {
+            LOG_WRN("Setting %s given twice", setting->name);
+            return -EINVAL;
+        }
+        if (values[i].value < setting->min || values[i].value > setting->max) {
+            LOG_WRN("Setting %s out of range: %d", setting->name,
+                    values[i].value);
+            return -ERANGE;
+        }
+        changed[setting->id] = true;
+    }
+
+    // Groups see the proposed values on top of the current ones
+    for (size_t id = 1; id < ARRAY_SIZE(settings_by_id); id++) {
+        if (settings_by_id[id]) {
+            previous[id] = proposed[id] = settings_by_id[id]->get();
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        proposed[values[i].id] = values[i].value;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const struct zmk_setting *setting = zmk_setting_find(values[i].id);
+        if (setting->group && setting->group->validate &&
+            !setting->group->validate(proposed)) {
+            LOG_WRN("Setting %s rejected by its group", setting->name);
+            return -EINVAL;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const struct zmk_setting *setting = zmk_setting_find(values[i].id);
+        if (setting->group && group_seen(values, i, setting->group)) {
+            continue;
+        }
+
+        int rc = apply_setting(setting, proposed);
+        if (rc < 0) {
+            LOG_WRN("Failed to apply setting %s: %d", setting->name, rc);
+            rollback_batch(values, i, previous);
+            return rc;
+        }
+    }
+    return 0;
+}
+
+int zmk_setting_set(uint32_t id, uint32_t value) {
+    struct zmk_setting_value setting = {.id = id, .value = value};
+    return zmk_setting_set_batch(&setting, 1);
+}
+
+int zmk_settings_relay_to(uint8_t dest) {
+    int ret = 0;
+
+    for (size_t id = 1; id < ARRAY_SIZE(settings_by_id); id++) {
+        const struct zmk_setting *setting = settings_by_id[id];
+        if (!setting || setting->relay == ZMK_SETTING_RELAY_NONE) {
+            continue;
+        }
+
+        // Groups are relayed as a whole, once
+        bool seen = false;
+        for (size_t prev = 1; setting->group && prev < id; prev++) {
+            seen |= settings_by_id[prev] &&
+                    settings_by_id[prev]->group == setting->group;
+        }
+        if (seen) {
+            continue;
+        }
+
+        int rc = setting->group ? setting->group->relay_to(dest)
+                                : setting->relay_to(dest);
+        if (rc < 0) {
+            LOG_WRN("Failed to relay setting %s: %d", setting->name, rc);
+            ret = ret < 0 ? ret : rc;
+        }
+    }
+    return ret;
+}
+
+uint32_t zmk_settings_digest(void) {
+    uint32_t crc = 0;
+
+    for (size_t id = 1; id < ARRAY_SIZE(settings_by_id); id++) {
+        const struct zmk_setting *setting = settings_by_id[id];
+        if (!setting || setting->relay == ZMK_SETTING_RELAY_NONE) {
+            continue;
+        }
+
+        // Fixed byte order, so devices of any endianness agree
+        uint8_t entry[6];
+        sys_put_le16(id, entry);
+        sys_put_le32(setting->inherited ? setting->inherited() : setting->get(),
+                     &entry[2]);
+        crc = crc32_ieee_update(crc, entry, sizeof(entry));
+    }
+    return crc;
+}
+
+uint32_t zmk_settings_generation(void) {
+    return (uint32_t)atomic_get(&generation);
+}
+
+void zmk_settings_generation_bump(void) {
+    // Skip 0, which clients use for "unknown"
+    if ((uint32_t)(atomic_inc(&generation) + 1) == 0) {
+        atomic_inc(&generation);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+/**
+ * A peripheral that (re)connects may hold other settings than the ones the
+ * clients have seen, so the generation of the keyboard as seen from the
+ * central changes with it.
+ */
+static int setting_peripheral_status_listener(const zmk_event_t *eh) {
+    if (as_zmk_split_peripheral_status_changed(eh)) {
+        zmk_settings_generation_bump();
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(setting_generation, setting_peripheral_status_listener);
+ZMK_SUBSCRIPTION(setting_generation, zmk_split_peripheral_status_changed);
+#endif
+
+static int setting_registry_init(void) {
+    STRUCT_SECTION_FOREACH(zmk_setting, setting) {
+        const struct zmk_setting *taken = settings_by_id[setting->id];
+        if (taken) {
+            LOG_ERR("Settings %s and %s share id %d", taken->name,
+                    setting->name, setting->id);
+            __ASSERT(false, "Duplicate setting id %d", setting->id);
+            continue;
+        }
+        __ASSERT(setting->relay == ZMK_SETTING_RELAY_NONE ||
+                     (setting->group ? setting->group->relay_to
+                                     : setting->relay_to),
+                 "Relayed setting %s has no relay_to", setting->name);
+        settings_by_id[setting->id] = setting;
+    }
+    return 0;
+}
+
+SYS_INIT(setting_registry_init, PRE_KERNEL_1, 0);
+
+/**
+ * Seed the generation once the entropy driver is up; it is not yet at
+ * PRE_KERNEL_1. Clients cannot ask for the generation before then.
+ */
+static int setting_generation_init(void) {
+    atomic_set(&generation, (atomic_val_t)(sys_rand32_get() | 1));
+    return 0;
+}
+
+SYS_INIT(setting_generation_init, APPLICATION,
+         CONFIG_APPLICATION_INIT_PRIORITY);
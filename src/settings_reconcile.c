@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Reconciliation of relayed settings when a peripheral (re)connects.
+ *
+ * A peripheral that was out of range or asleep misses the settings relayed
+ * in the meantime. Once it is back, the central asks every peripheral for a
+ * digest of the relayed settings it inherits from the central, leaving out
+ * the ones it has its own values of, and compares it with its own. Only if
+ * they differ are the central's settings relayed again, to that peripheral
+ * alone, so a peripheral that is in sync costs a request and a report of a
+ * few bytes each.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/events/settings_digest.h>
+#include <zmk/events/split_peripheral_status_changed.h>
+#include <zmk/settings_rpc/setting.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Sequence number of the latest digest request
+static uint8_t digest_seq;
+static K_MUTEX_DEFINE(reconcile_lock);
+
+static void digest_request_work_handler(struct k_work *work) {
+    k_mutex_lock(&reconcile_lock, K_FOREVER);
+    struct zmk_settings_digest_request request = {.seq = ++digest_seq};
+    k_mutex_unlock(&reconcile_lock);
+
+    raise_zmk_settings_digest_request(request);
+    LOG_DBG("Requested settings digests (request %d)", request.seq);
+}
+
+static K_WORK_DELAYABLE_DEFINE(digest_request_work,
+                               digest_request_work_handler);
+
+/**
+ * Ask for digests a moment after a peripheral connects, so the relay of the
+ * new connection is ready. Peripherals connecting together are asked once.
+ */
+static int settings_reconcile_status_listener(const zmk_event_t *eh) {
+    const struct zmk_split_peripheral_status_changed *ev =
+        as_zmk_split_peripheral_status_changed(eh);
+    if (ev && ev->connected) {
+        k_work_reschedule(&digest_request_work,
+                          K_MSEC(CONFIG_ZMK_SETTINGS_RPC_RECONCILE_DELAY_MS));
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_reconcile_status, settings_reconcile_status_listener);
+ZMK_SUBSCRIPTION(settings_reconcile_status,
+                 zmk_split_peripheral_status_changed);
+
+static int settings_digest_report_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_digest_report *ev =
+        as_zmk_settings_digest_report(eh);
+    if (!ev || ev->source == ZMK_RELAY_EVENT_SOURCE_SELF) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_mutex_lock(&reconcile_lock, K_FOREVER);
+    bool current = ev->seq == digest_seq;
+    k_mutex_unlock(&reconcile_lock);
+    if (!current) {
+        LOG_DBG("Dropped stale settings digest from %d for request %d",
+                ev->source, ev->seq);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint32_t crc = zmk_settings_digest();
+    if (ev->crc == crc) {
+        LOG_DBG("Peripheral %d settings in sync (generation %u)", ev->source,
+                ev->generation);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // Peripherals in sync are left alone
+    LOG_INF("Peripheral %d settings digest 0x%08x differs from 0x%08x, "
+            "relaying settings",
+            ev->source, ev->crc, crc);
+    int rc = zmk_settings_relay_to(ZMK_SETTINGS_RELAY_DEST(ev->source));
+    if (rc < 0) {
+        LOG_ERR("Failed to relay settings to peripheral %d: %d", ev->source,
+                rc);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_reconcile_digest, settings_digest_report_listener);
+ZMK_SUBSCRIPTION(settings_reconcile_digest, zmk_settings_digest_report);
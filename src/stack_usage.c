@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Peak stack use of the threads module code runs on.
+ *
+ * Module code runs on threads it does not own: the Studio RPC thread, the
+ * work queues and whichever thread the split transport raises relayed events
+ * on, with the event manager on top. Each path samples the painted stack of
+ * the thread it runs on, so the recorded peaks show how much of each stack
+ * is actually used, including by the code that called into the module.
+ */
+
+#include <zephyr/kernel.h>
+#include <zmk/settings_rpc/stack_usage.h>
+
+static struct zmk_settings_stack_usage
+    threads[ZMK_SETTINGS_STACK_USAGE_MAX_THREADS];
+static size_t thread_count;
+static K_MUTEX_DEFINE(threads_lock);
+
+void zmk_settings_stack_sample(enum zmk_settings_stack_path path) {
+    struct k_thread *thread = k_current_get();
+    size_t unused;
+
+    // Scanned before taking the lock, so samples do not wait on each other
+    if (k_thread_stack_space_get(thread, &unused) < 0) {
+        return;
+    }
+    size_t size = thread->stack_info.size;
+
+    k_mutex_lock(&threads_lock, K_FOREVER);
+    struct zmk_settings_stack_usage *usage = NULL;
+    for (size_t i = 0; i < thread_count; i++) {
+        if (threads[i].thread == thread) {
+            usage = &threads[i];
+            break;
+        }
+    }
+    if (!usage && thread_count < ARRAY_SIZE(threads)) {
+        usage  = &threads[thread_count++];
+        *usage = (struct zmk_settings_stack_usage){
+            .thread = thread,
+            .size   = size,
+        };
+    }
+    if (usage) {
+        usage->peak = MAX(usage->peak, size - unused);
+        usage->paths |= BIT(path);
+    }
+    k_mutex_unlock(&threads_lock);
+}
+
+size_t zmk_settings_stack_usage_get(struct zmk_settings_stack_usage *usage,
+                                    size_t max) {
+    k_mutex_lock(&threads_lock, K_FOREVER);
+    size_t count = MIN(thread_count, max);
+    for (size_t i = 0; i < count; i++) {
+        usage[i] = threads[i];
+    }
+    k_mutex_unlock(&threads_lock);
+    return count;
+}
@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Collection of activity settings from the central and its peripherals for
+ * GetAllActivitySettings requests.
+ *
+ * Every query gets its own request id, which peripherals echo back in their
+ * reports. The central keeps a small table of queries in flight, so reports
+ * are matched to the query that asked for them and late reports from an
+ * earlier query are dropped. A single delayable work item expires the query
+ * with the earliest deadline.
+ *
+ * Queries are single-flight: a query started while another one of the same
+ * kind is in flight joins it instead of asking the peripherals again, and all
+ * callers are answered by the same round of reports.
+ *
+ * The central also caches the last settings reported by each peripheral,
+ * whether asked for or reported on change. While every peripheral has a valid
+ * cache entry, queries are answered from the cache without touching the split
+ * link. Entries are invalidated when a peripheral connects or disconnects,
+ * when it fails to answer a query, when a relay to it goes unacknowledged, and
+ * when settings are relayed to it, until it reports the settings it applied.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_settings_changed.h>
+#include <zmk/events/activity_settings_override.h>
+#include <zmk/events/activity_settings_report.h>
+#include <zmk/events/settings_address.h>
+#include <zmk/settings_rpc/stack_usage.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/events/split_peripheral_status_changed.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE)
+#include <zmk/events/settings_relay.h>
+#endif
+
+#include "settings_rpc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Request id of reports that were not requested by a query
+#define UNSOLICITED_REQUEST_ID 0
+
+BUILD_ASSERT(ZMK_SETTINGS_RPC_PERIPHERAL_COUNT + 1 <=
+                 ARRAY_SIZE(((zmk_settings_AllActivitySettingsNotification *)0)
+                                ->settings),
+             "AllActivitySettingsNotification.settings max_count is too small "
+             "for the number of peripherals");
+
+struct reported_settings {
+    uint32_t idle_ms;
+    uint32_t sleep_ms;
+    bool own;  // Not inherited from the central
+};
+
+/**
+ * A query in flight. A slot is free when request_id is 0.
+ * Reports are kept per source until the query completes. Aggregated queries
+ * send them all at once; other queries forward them as they arrive, and
+ * replay them to callers that join later.
+ */
+struct activity_settings_query {
+    uint8_t request_id;
+    bool aggregate;
+    uint32_t pending_mask;
+    int64_t deadline;
+    struct reported_settings reported[ZMK_SETTINGS_RPC_PERIPHERAL_COUNT + 1];
+};
+
+struct cached_settings {
+    bool valid;
+    struct reported_settings settings;
+};
+
+/**
+ * Queries are started from the Studio RPC thread, reports are received on the
+ * split relay path and deadlines expire on the system work queue.
+ */
+static struct activity_settings_query
+    queries[CONFIG_ZMK_SETTINGS_RPC_MAX_INFLIGHT_QUERIES];
+// Indexed by source; the central's entry is unused
+static struct cached_settings cache[ZMK_SETTINGS_RPC_PERIPHERAL_COUNT + 1];
+static uint8_t last_request_id;
+static K_MUTEX_DEFINE(queries_lock);
+
+static void query_timeout_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(query_timeout_work, query_timeout_handler);
+
+/**
+ * Find the query with the given request id.
+ * Looking up UNSOLICITED_REQUEST_ID returns a free slot.
+ */
+static struct activity_settings_query *find_query(uint8_t request_id) {
+    for (size_t i = 0; i < ARRAY_SIZE(queries); i++) {
+        if (queries[i].request_id == request_id) {
+            return &queries[i];
+        }
+    }
+    return NULL;
+}
+
+// Query in flight of the given kind, if any
+static struct activity_settings_query *find_inflight(bool aggregate) {
+    for (size_t i = 0; i < ARRAY_SIZE(queries); i++) {
+        if (queries[i].request_id != UNSOLICITED_REQUEST_ID &&
+            queries[i].aggregate == aggregate) {
+            return &queries[i];
+        }
+    }
+    return NULL;
+}
+
+// Monotonically increasing id, skipping 0 and ids still in flight on wrap
+static uint8_t next_request_id(void) {
+    do {
+        last_request_id++;
+    } while (last_request_id == UNSOLICITED_REQUEST_ID ||
+             find_query(last_request_id));
+    return last_request_id;
+}
+
+/**
+ * Fill in the reports of a new query from the cache if every peripheral has
+ * a valid entry. Must be called with queries_lock held.
+ */
+static bool answer_from_cache(struct activity_settings_query *q) {
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (!cache[source].valid) {
+            return false;
+        }
+    }
+
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        q->reported[source] = cache[source].settings;
+    }
+    q->pending_mask = 0;
+    return true;
+}
+
+// Must be called with queries_lock held
+static void cache_update(uint32_t source,
+                         const struct reported_settings *settings) {
+    if (source == SETTINGS_RPC_SOURCE_CENTRAL ||
+        source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) {
+        return;
+    }
+    cache[source] = (struct cached_settings){
+        .valid    = true,
+        .settings = *settings,
+    };
+}
+
+static size_t list_timed_out_sources(const struct activity_settings_query *q,
+                                     uint32_t *sources) {
+    size_t count = 0;
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (q->pending_mask & BIT(source)) {
+            sources[count++] = source;
+        }
+    }
+    return count;
+}
+
+/**
+ * Send the completion notification of a query and free its slot.
+ * Peripherals that have not answered are listed as timed out.
+ * Must be called with queries_lock held.
+ */
+static void finish_query(struct activity_settings_query *q) {
+    zmk_settings_Notification notification =
+        zmk_settings_Notification_init_zero;
+
+    if (q->aggregate) {
+        notification.which_notification_type =
+            zmk_settings_Notification_all_activity_settings_tag;
+        zmk_settings_AllActivitySettingsNotification *all =
+            &notification.notification_type.all_activity_settings;
+
+        all->request_id = q->request_id;
+        for (uint32_t source = 0; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+             source++) {
+            if (q->pending_mask & BIT(source)) {
+                continue;
+            }
+            zmk_settings_ActivitySettings *settings =
+                &all->settings[all->settings_count++];
+            settings->idle_ms  = q->reported[source].idle_ms;
+            settings->sleep_ms = q->reported[source].sleep_ms;
+            settings->own      = q->reported[source].own;
+            settings->source   = source;
+        }
+        all->timed_out_sources_count =
+            list_timed_out_sources(q, all->timed_out_sources);
+    } else {
+        notification.which_notification_type =
+            zmk_settings_Notification_activity_settings_query_complete_tag;
+        zmk_settings_ActivitySettingsQueryCompleteNotification *complete =
+            &notification.notification_type.activity_settings_query_complete;
+
+        complete->request_id = q->request_id;
+        complete->timed_out_sources_count =
+            list_timed_out_sources(q, complete->timed_out_sources);
+    }
+
+    // Peripherals that did not answer may hold other settings by now
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (q->pending_mask & BIT(source)) {
+            cache[source].valid = false;
+        }
+    }
+
+    LOG_DBG("Activity settings query %d finished, missing 0x%x", q->request_id,
+            q->pending_mask);
+    q->request_id = UNSOLICITED_REQUEST_ID;
+
+    settings_rpc_notify(&notification);
+}
+
+/**
+ * Schedule the timeout work for the earliest deadline in flight.
+ * Must be called with queries_lock held.
+ */
+static void schedule_next_timeout(void) {
+    int64_t next = INT64_MAX;
+    for (size_t i = 0; i < ARRAY_SIZE(queries); i++) {
+        if (queries[i].request_id != UNSOLICITED_REQUEST_ID) {
+            next = MIN(next, queries[i].deadline);
+        }
+    }
+
+    if (next == INT64_MAX) {
+        k_work_cancel_delayable(&query_timeout_work);
+        return;
+    }
+    k_work_reschedule(&query_timeout_work,
+                      K_MSEC(MAX(next - k_uptime_get(), 0)));
+}
+
+static void query_timeout_handler(struct k_work *work) {
+    k_mutex_lock(&queries_lock, K_FOREVER);
+    int64_t now = k_uptime_get();
+    for (size_t i = 0; i < ARRAY_SIZE(queries); i++) {
+        if (queries[i].request_id != UNSOLICITED_REQUEST_ID &&
+            queries[i].deadline <= now) {
+            LOG_WRN("Activity settings query %d timed out",
+                    queries[i].request_id);
+            finish_query(&queries[i]);
+        }
+    }
+    schedule_next_timeout();
+    k_mutex_unlock(&queries_lock);
+}
+
+/**
+ * Send the reports a non-aggregated query has received so far, when it
+ * starts or again for a caller that joined it.
+ * Must be called with queries_lock held.
+ */
+static void replay_reports(const struct activity_settings_query *q) {
+    for (uint32_t source = 0; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (!(q->pending_mask & BIT(source))) {
+            settings_rpc_notify_activity_settings(
+                q->reported[source].idle_ms, q->reported[source].sleep_ms,
+                q->reported[source].own, source, q->request_id);
+        }
+    }
+}
+
+int activity_settings_collect(bool aggregate, bool force, uint8_t *request_id,
+                              bool *joined) {
+    k_mutex_lock(&queries_lock, K_FOREVER);
+
+    struct activity_settings_query *q = find_inflight(aggregate);
+    if (q) {
+        // The peripherals have been asked already: answer with the same round
+        *request_id = q->request_id;
+        *joined     = true;
+        if (!aggregate) {
+            replay_reports(q);
+        }
+        k_mutex_unlock(&queries_lock);
+        LOG_DBG("Joined activity settings query %d", *request_id);
+        return 0;
+    }
+
+    q = find_query(UNSOLICITED_REQUEST_ID);
+    if (!q) {
+        k_mutex_unlock(&queries_lock);
+        LOG_WRN("Too many activity settings queries in flight");
+        return -EBUSY;
+    }
+
+    *q = (struct activity_settings_query){
+        .request_id   = next_request_id(),
+        .aggregate    = aggregate,
+        .pending_mask = ZMK_SETTINGS_RPC_ALL_PERIPHERALS_MASK,
+        .deadline =
+            k_uptime_get() + CONFIG_ZMK_SETTINGS_RPC_COLLECT_TIMEOUT_MS,
+    };
+    *request_id = q->request_id;
+    *joined     = false;
+
+    bool cached = !force && answer_from_cache(q);
+
+    q->reported[SETTINGS_RPC_SOURCE_CENTRAL] = (struct reported_settings){
+        .idle_ms  = zmk_activity_get_idle_ms(),
+        .sleep_ms = zmk_activity_get_sleep_ms(),
+    };
+    if (!aggregate) {
+        // Send the central's settings, and the cached ones, immediately
+        replay_reports(q);
+    }
+
+    if (q->pending_mask == 0) {
+        finish_query(q);
+    } else {
+        schedule_next_timeout();
+    }
+    k_mutex_unlock(&queries_lock);
+
+    if (cached) {
+        LOG_DBG("Answered activity settings query %d locally", *request_id);
+        return 0;
+    }
+
+#if ZMK_SETTINGS_RPC_PERIPHERAL_COUNT > 0
+    // Each peripheral answers with a zmk_activity_settings_report event
+    // carrying the same request id
+    struct zmk_activity_settings_request request_event = {
+        .request_id = *request_id,
+    };
+    raise_zmk_activity_settings_request(request_event);
+    LOG_DBG("Requested settings from peripherals for query %d", *request_id);
+#endif
+
+    return 0;
+}
+
+bool activity_settings_peripheral_may_own(void) {
+    bool may_own = false;
+
+    k_mutex_lock(&queries_lock, K_FOREVER);
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        may_own |= !cache[source].valid || cache[source].settings.own;
+    }
+    k_mutex_unlock(&queries_lock);
+    return may_own;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+
+#if !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
+// Relay request events from central to peripherals
+ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_activity_settings_request, srq, );
+
+ZMK_RELAY_EVENT_HANDLE(zmk_activity_settings_report, srp, source);
+#endif
+
+/**
+ * Match a peripheral report against the query that requested it.
+ * Reports for unknown or finished queries, and duplicate reports, are dropped.
+ */
+static void collect_report(const struct zmk_activity_settings_report *ev) {
+    k_mutex_lock(&queries_lock, K_FOREVER);
+
+    struct activity_settings_query *q = find_query(ev->request_id);
+    if (!q || ev->source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT ||
+        !(q->pending_mask & BIT(ev->source))) {
+        k_mutex_unlock(&queries_lock);
+        LOG_DBG("Dropped stale settings report from %d for query %d",
+                ev->source, ev->request_id);
+        return;
+    }
+
+    q->pending_mask &= ~BIT(ev->source);
+    q->reported[ev->source] = (struct reported_settings){
+        .idle_ms  = ev->idle_ms,
+        .sleep_ms = ev->sleep_ms,
+        .own      = ev->own,
+    };
+    cache_update(ev->source, &q->reported[ev->source]);
+    if (!q->aggregate) {
+        settings_rpc_notify_activity_settings(ev->idle_ms, ev->sleep_ms,
+                                              ev->own, ev->source,
+                                              q->request_id);
+    }
+
+    if (q->pending_mask == 0) {
+        finish_query(q);
+        schedule_next_timeout();
+    }
+    k_mutex_unlock(&queries_lock);
+}
+
+/**
+ * Event listener to handle settings reports from peripherals
+ * Send them as notifications to the web UI
+ */
+static int activity_settings_report_listener(const zmk_event_t *eh) {
+    struct zmk_activity_settings_report *ev =
+        as_zmk_activity_settings_report(eh);
+    if (!ev) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_RELAY_RECEIVE);
+
+    LOG_DBG("Received settings report from peripheral %d for query %d: "
+            "idle=%d, sleep=%d",
+            ev->source, ev->request_id, ev->idle_ms, ev->sleep_ms);
+
+    if (ev->request_id == UNSOLICITED_REQUEST_ID) {
+        struct reported_settings settings = {
+            .idle_ms  = ev->idle_ms,
+            .sleep_ms = ev->sleep_ms,
+            .own      = ev->own,
+        };
+        k_mutex_lock(&queries_lock, K_FOREVER);
+        cache_update(ev->source, &settings);
+        k_mutex_unlock(&queries_lock);
+
+        // Settings changed on the peripheral: push to subscribed clients
+        settings_rpc_push_peripheral_settings(ev->source, ev->idle_ms,
+                                              ev->sleep_ms);
+    } else {
+        collect_report(ev);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_report_handler,
+             activity_settings_report_listener);
+ZMK_SUBSCRIPTION(activity_settings_report_handler,
+                 zmk_activity_settings_report);
+
+// Must be called with queries_lock held
+static void cache_invalidate(uint8_t dest) {
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (dest & ZMK_SETTINGS_RELAY_DEST(source)) {
+            cache[source].valid = false;
+        }
+    }
+}
+
+/**
+ * Settings changed on the central are relayed to the peripherals they are
+ * addressed to, which apply them unless they have their own. Whether they
+ * did is only known from their report, so their cache entries are dropped
+ * until then; peripherals with their own settings keep theirs.
+ */
+static int activity_settings_cache_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_settings_changed *ev =
+        as_zmk_activity_settings_changed(eh);
+    if (!ev || ev->source != ZMK_RELAY_EVENT_SOURCE_SELF) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint8_t dest = ev->dest;
+    k_mutex_lock(&queries_lock, K_FOREVER);
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        if (cache[source].valid && cache[source].settings.own) {
+            dest &= ~ZMK_SETTINGS_RELAY_DEST(source);
+        }
+    }
+    cache_invalidate(dest);
+    k_mutex_unlock(&queries_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_cache, activity_settings_cache_listener);
+ZMK_SUBSCRIPTION(activity_settings_cache, zmk_activity_settings_changed);
+
+/**
+ * Peripherals given settings of their own, or made to inherit the central's
+ * again, report the settings they apply: drop their cache entries until then.
+ */
+static int activity_settings_override_cache_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_settings_override *ev =
+        as_zmk_activity_settings_override(eh);
+    if (!ev || ev->source != ZMK_RELAY_EVENT_SOURCE_SELF) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_mutex_lock(&queries_lock, K_FOREVER);
+    cache_invalidate(ev->dest);
+    k_mutex_unlock(&queries_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_override_cache,
+             activity_settings_override_cache_listener);
+ZMK_SUBSCRIPTION(activity_settings_override_cache,
+                 zmk_activity_settings_override);
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+/**
+ * A peripheral that did not acknowledge a relayed event, or failed to apply
+ * it, holds settings the cache cannot tell: drop its entry, so the next query
+ * asks it again.
+ */
+static int activity_settings_delivery_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_relay_delivery *ev =
+        as_zmk_settings_relay_delivery(eh);
+    if (!ev || ev->status == 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_mutex_lock(&queries_lock, K_FOREVER);
+    cache_invalidate(ZMK_SETTINGS_RELAY_DEST(ev->source));
+    k_mutex_unlock(&queries_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_cache_delivery,
+             activity_settings_delivery_listener);
+ZMK_SUBSCRIPTION(activity_settings_cache_delivery,
+                 zmk_settings_relay_delivery);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+/**
+ * A peripheral that (re)connects may have changed its settings while it was
+ * away. The event does not tell which relay source it is, so the cache of
+ * every peripheral is dropped.
+ */
+static int activity_settings_peripheral_status_listener(const zmk_event_t *eh) {
+    if (!as_zmk_split_peripheral_status_changed(eh)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_mutex_lock(&queries_lock, K_FOREVER);
+    for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+        cache[i].valid = false;
+    }
+    k_mutex_unlock(&queries_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_settings_cache_status,
+             activity_settings_peripheral_status_listener);
+ZMK_SUBSCRIPTION(activity_settings_cache_status,
+                 zmk_split_peripheral_status_changed);
+#endif
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <pb_encode.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/settings_rpc/custom_notification.h>
+#include <zmk/studio/custom.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+/**
+ * Notifications are serialized once into this scratch buffer and the encode
+ * callback copies the bytes out. The Studio encoder invokes the callback for
+ * both its sizing pass and its write pass, so encoding the message inside the
+ * callback would serialize it several times per notification.
+ */
+static uint8_t scratch_buf[CONFIG_ZMK_SETTINGS_RPC_NOTIFICATION_BUFFER_SIZE];
+static bool scratch_busy;
+static K_MUTEX_DEFINE(scratch_lock);
+
+struct custom_notification_payload {
+    const uint8_t *bytes;
+    size_t size;
+};
+
+int zmk_rpc_custom_notifier_resolve(struct zmk_rpc_custom_notifier *notifier) {
+    if (notifier->index >= 0) {
+        return notifier->index;
+    }
+
+    size_t subsystem_count;
+    STRUCT_SECTION_COUNT(zmk_rpc_custom_subsystem, &subsystem_count);
+
+    for (size_t i = 0; i < subsystem_count; i++) {
+        struct zmk_rpc_custom_subsystem *custom_subsys;
+        STRUCT_SECTION_GET(zmk_rpc_custom_subsystem, i, &custom_subsys);
+        if (strcmp(custom_subsys->identifier, notifier->identifier) == 0) {
+            notifier->index = (int)i;
+            return notifier->index;
+        }
+    }
+
+    LOG_ERR("Custom subsystem %s is not registered", notifier->identifier);
+    return -ENOENT;
+}
+
+static bool encode_custom_notification_payload(pb_ostream_t *stream,
+                                               const pb_field_t *field,
+                                               void *const *arg) {
+    const struct custom_notification_payload *payload = *arg;
+    if (!pb_encode_tag_for_field(stream, field)) {
+        return false;
+    }
+    return pb_encode_string(stream, payload->bytes, payload->size);
+}
+
+int zmk_rpc_custom_notify(struct zmk_rpc_custom_notifier *notifier,
+                          const pb_msgdesc_t *fields, const void *message) {
+    int subsystem_idx = zmk_rpc_custom_notifier_resolve(notifier);
+    if (subsystem_idx < 0) {
+        return subsystem_idx;
+    }
+
+    k_mutex_lock(&scratch_lock, K_FOREVER);
+    if (scratch_busy) {
+        // Raised from a listener of the notification being sent
+        k_mutex_unlock(&scratch_lock);
+        LOG_WRN("Nested notification for %s dropped", notifier->identifier);
+        return -EBUSY;
+    }
+
+    pb_ostream_t stream =
+        pb_ostream_from_buffer(scratch_buf, sizeof(scratch_buf));
+    if (!pb_encode(&stream, fields, message)) {
+        k_mutex_unlock(&scratch_lock);
+        LOG_WRN("Failed to encode notification: %s", PB_GET_ERROR(&stream));
+        return -EMSGSIZE;
+    }
+
+    struct custom_notification_payload payload = {
+        .bytes = scratch_buf,
+        .size  = stream.bytes_written,
+    };
+    struct zmk_studio_custom_notification event = {
+        .subsystem_index = subsystem_idx,
+        .encode_payload =
+            {
+                .funcs = {.encode = encode_custom_notification_payload},
+                .arg   = &payload,
+            },
+    };
+
+    scratch_busy = true;
+    raise_zmk_studio_custom_notification(event);
+    scratch_busy = false;
+    k_mutex_unlock(&scratch_lock);
+    return 0;
+}
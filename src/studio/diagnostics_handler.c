@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Diagnostics RPCs, for sizing the resources the module runs with.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <pb_encode.h>
+#include <zmk/settings/core.pb.h>
+#include <zmk/settings_rpc/relay_stats.h>
+#include <zmk/settings_rpc/stack_usage.h>
+
+#include "settings_rpc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+BUILD_ASSERT(ZMK_SETTINGS_STACK_USAGE_MAX_THREADS <=
+                 ARRAY_SIZE(((zmk_settings_GetStackUsageResponse *)0)->threads),
+             "GetStackUsageResponse.threads is too small");
+BUILD_ASSERT(ZMK_SETTINGS_STACK_PATH_COUNT <=
+                 ARRAY_SIZE(((zmk_settings_ThreadStackUsage *)0)->paths),
+             "ThreadStackUsage.paths is too small");
+BUILD_ASSERT(ZMK_SETTINGS_RELAY_ID_COUNT <=
+                 ARRAY_SIZE(((zmk_settings_PeripheralRelayStats *)0)->events),
+             "PeripheralRelayStats.events is too small");
+BUILD_ASSERT(ZMK_SETTINGS_RELAY_RTT_BUCKETS <=
+                 ARRAY_SIZE(((zmk_settings_PeripheralRelayStats *)0)
+                                ->round_trip_buckets),
+             "PeripheralRelayStats.round_trip_buckets is too small");
+
+int settings_rpc_handle_get_stack_usage(
+    const zmk_settings_GetStackUsageRequest *req,
+    zmk_settings_Response *resp) {
+    struct zmk_settings_stack_usage usage[ZMK_SETTINGS_STACK_USAGE_MAX_THREADS];
+    size_t count = zmk_settings_stack_usage_get(usage, ARRAY_SIZE(usage));
+
+    resp->which_response_type = zmk_settings_Response_get_stack_usage_tag;
+    zmk_settings_GetStackUsageResponse *result =
+        &resp->response_type.get_stack_usage;
+    *result = (zmk_settings_GetStackUsageResponse){
+        .enabled = IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STACK_USAGE),
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        zmk_settings_ThreadStackUsage *thread =
+            &result->threads[result->threads_count++];
+        const char *name = k_thread_name_get((k_tid_t)usage[i].thread);
+
+        snprintf(thread->name, sizeof(thread->name), "%s", name ? name : "");
+        thread->size = usage[i].size;
+        thread->peak = usage[i].peak;
+        for (int path = 0; path < ZMK_SETTINGS_STACK_PATH_COUNT; path++) {
+            if (usage[i].paths & BIT(path)) {
+                thread->paths[thread->paths_count++] =
+                    (zmk_settings_StackPath)path;
+            }
+        }
+    }
+
+    LOG_DBG("Reporting stack usage of %d threads", (int)count);
+    return 0;
+}
+
+int settings_rpc_handle_get_stats(const zmk_settings_GetStatsRequest *req,
+                                  zmk_settings_Response *resp) {
+    resp->which_response_type = zmk_settings_Response_get_stats_tag;
+    zmk_settings_GetStatsResponse *result = &resp->response_type.get_stats;
+    *result = (zmk_settings_GetStatsResponse){
+        .enabled               = IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STATS),
+        .notifications_dropped = settings_rpc_notifications_dropped(),
+    };
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STATS)
+    result->requests.funcs.encode = settings_rpc_stats_encode_requests;
+#endif
+    return 0;
+}
+
+/**
+ * Encode callback of GetRelayStatsResponse.peripherals, writing the
+ * statistics of every peripheral one at a time.
+ */
+static bool encode_relay_stats(pb_ostream_t *stream, const pb_field_t *field,
+                               void *const *arg) {
+    for (uint8_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        struct zmk_settings_relay_event_stats
+            events[ZMK_SETTINGS_RELAY_ID_COUNT];
+        struct zmk_settings_relay_rtt_stats rtt;
+        if (zmk_settings_relay_stats_get(source, events, &rtt) < 0) {
+            continue;
+        }
+
+        zmk_settings_PeripheralRelayStats msg =
+            zmk_settings_PeripheralRelayStats_init_zero;
+        msg.source                   = source;
+        msg.round_trips              = rtt.count;
+        msg.round_trip_max_us        = rtt.max_us;
+        msg.round_trip_buckets_count = ZMK_SETTINGS_RELAY_RTT_BUCKETS;
+        memcpy(msg.round_trip_buckets, rtt.buckets, sizeof(rtt.buckets));
+
+        for (uint16_t id = 0; id < ZMK_SETTINGS_RELAY_ID_COUNT; id++) {
+            const struct zmk_settings_relay_event_stats *ev = &events[id];
+            if (!ev->sent && !ev->received && !ev->dropped && !ev->rejected) {
+                continue;
+            }
+            msg.events[msg.events_count++] = (zmk_settings_RelayEventStats){
+                .relay_id        = id,
+                .events_sent     = ev->sent,
+                .bytes_sent      = ev->sent_bytes,
+                .events_received = ev->received,
+                .bytes_received  = ev->received_bytes,
+                .dropped         = ev->dropped,
+                .rejected        = ev->rejected,
+            };
+        }
+
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_submessage(
+                stream, zmk_settings_PeripheralRelayStats_fields, &msg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int settings_rpc_handle_get_relay_stats(
+    const zmk_settings_GetRelayStatsRequest *req,
+    zmk_settings_Response *resp) {
+    resp->which_response_type = zmk_settings_Response_get_relay_stats_tag;
+    zmk_settings_GetRelayStatsResponse *result =
+        &resp->response_type.get_relay_stats;
+    *result = (zmk_settings_GetRelayStatsResponse){
+        .enabled = IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_STATS),
+    };
+    result->peripherals.funcs.encode = encode_relay_stats;
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Queue of notifications to the web UI.
+ *
+ * Notifications are raised from listeners, including the split relay receive
+ * path, so encoding and sending them there would hold up the thread that also
+ * delivers key events. settings_rpc_notify() only stores the notification in
+ * a fixed number of slots, and a work item on the low priority work queue
+ * sends them in order.
+ *
+ * Settings reports of the same type, device and query replace each other while
+ * queued, so a burst of reports from a peripheral takes a single slot. The
+ * merged report is sent in the place of the newest one, after anything queued
+ * in between, such as the completion of the query it answers. When all slots
+ * are taken, the oldest queued report is dropped to make room;
+ * query completions are never dropped in its favour, since clients wait for
+ * them. Drops are counted.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/settings_rpc/setting.h>
+#include <zmk/settings_rpc/stack_usage.h>
+#include <zmk/workqueue.h>
+
+#include "settings_rpc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+struct queued_notification {
+    bool used;
+    // Order in which slots are sent
+    uint32_t seq;
+    zmk_settings_Notification notification;
+};
+
+static struct queued_notification
+    queue[CONFIG_ZMK_SETTINGS_RPC_NOTIFICATION_QUEUE_SIZE];
+static uint32_t next_seq;
+static uint32_t dropped;
+static K_MUTEX_DEFINE(queue_lock);
+
+// Copy being sent, only touched by the drain work
+static zmk_settings_Notification sending;
+
+static void drain_work_handler(struct k_work *work);
+static K_WORK_DEFINE(drain_work, drain_work_handler);
+
+/**
+ * Whether a notification reports the state of a device, so a newer one of the
+ * same type and device supersedes it. Sets @p source to the device.
+ */
+static bool is_state_report(const zmk_settings_Notification *notification,
+                            uint32_t *source) {
+    switch (notification->which_notification_type) {
+        case zmk_settings_Notification_activity_settings_tag:
+            *source = notification->notification_type.activity_settings
+                          .settings.source;
+            return true;
+        case zmk_settings_Notification_settings_changed_tag:
+            *source = notification->notification_type.settings_changed.source;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Query a report answers, 0 if it was not requested
+static uint32_t
+report_request_id(const zmk_settings_Notification *notification) {
+    if (notification->which_notification_type ==
+        zmk_settings_Notification_activity_settings_tag) {
+        return notification->notification_type.activity_settings.request_id;
+    }
+    return 0;
+}
+
+// Merge the changed settings of @p from into @p into, if they fit
+static bool merge_settings_changed(
+    zmk_settings_SettingsChangedNotification *into,
+    const zmk_settings_SettingsChangedNotification *from) {
+    zmk_settings_SettingsChangedNotification merged = *into;
+
+    for (pb_size_t i = 0; i < from->settings_count; i++) {
+        pb_size_t j = 0;
+        while (j < merged.settings_count &&
+               merged.settings[j].id != from->settings[i].id) {
+            j++;
+        }
+        if (j == merged.settings_count) {
+            if (merged.settings_count == ARRAY_SIZE(merged.settings)) {
+                return false;
+            }
+            merged.settings_count++;
+        }
+        merged.settings[j] = from->settings[i];
+    }
+
+    *into = merged;
+    return true;
+}
+
+/**
+ * Merge @p notification into a queued report of the same type, device and
+ * query, and move it to the end of the queue. Must be called with queue_lock
+ * held.
+ */
+static bool merge_queued(const zmk_settings_Notification *notification) {
+    uint32_t source;
+    if (!is_state_report(notification, &source)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(queue); i++) {
+        zmk_settings_Notification *queued = &queue[i].notification;
+        uint32_t queued_source;
+        if (!queue[i].used ||
+            queued->which_notification_type !=
+                notification->which_notification_type ||
+            !is_state_report(queued, &queued_source) ||
+            queued_source != source ||
+            report_request_id(queued) != report_request_id(notification)) {
+            continue;
+        }
+
+        if (notification->which_notification_type ==
+            zmk_settings_Notification_settings_changed_tag) {
+            if (!merge_settings_changed(
+                    &queued->notification_type.settings_changed,
+                    &notification->notification_type.settings_changed)) {
+                return false;
+            }
+            queued->generation = notification->generation;
+        } else {
+            *queued = *notification;
+        }
+        queue[i].seq = next_seq++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Find the oldest slot matching @p state_only, or NULL.
+ * Must be called with queue_lock held.
+ */
+static struct queued_notification *find_oldest(bool state_only) {
+    struct queued_notification *oldest = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(queue); i++) {
+        uint32_t source;
+        if (!queue[i].used ||
+            (state_only &&
+             !is_state_report(&queue[i].notification, &source))) {
+            continue;
+        }
+        // Compared as a difference, so wrapping sequence numbers keep order
+        if (!oldest || (int32_t)(queue[i].seq - oldest->seq) < 0) {
+            oldest = &queue[i];
+        }
+    }
+    return oldest;
+}
+
+/**
+ * Find a free slot, dropping the oldest state report if there is none.
+ * Must be called with queue_lock held.
+ */
+static struct queued_notification *
+claim_slot(const zmk_settings_Notification *notification) {
+    for (size_t i = 0; i < ARRAY_SIZE(queue); i++) {
+        if (!queue[i].used) {
+            return &queue[i];
+        }
+    }
+
+    uint32_t source;
+    struct queued_notification *victim = find_oldest(true);
+    if (!victim && !is_state_report(notification, &source)) {
+        // Only completions are queued; keep them and drop the oldest
+        victim = find_oldest(false);
+    }
+    if (!victim) {
+        return NULL;
+    }
+
+    dropped++;
+    LOG_WRN("Notification queue full, dropped notification type %d (%u "
+            "dropped)",
+            victim->notification.which_notification_type, dropped);
+    return victim;
+}
+
+int settings_rpc_notify(zmk_settings_Notification *notification) {
+    notification->generation = zmk_settings_generation();
+
+    k_mutex_lock(&queue_lock, K_FOREVER);
+    int rc = 0;
+    if (!merge_queued(notification)) {
+        struct queued_notification *slot = claim_slot(notification);
+        if (slot) {
+            *slot = (struct queued_notification){
+                .used         = true,
+                .seq          = next_seq++,
+                .notification = *notification,
+            };
+        } else {
+            dropped++;
+            LOG_WRN("Notification queue full, dropped notification type %d "
+                    "(%u dropped)",
+                    notification->which_notification_type, dropped);
+            rc = -ENOBUFS;
+        }
+    }
+    k_mutex_unlock(&queue_lock);
+
+    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &drain_work);
+    return rc;
+}
+
+uint32_t settings_rpc_notifications_dropped(void) {
+    k_mutex_lock(&queue_lock, K_FOREVER);
+    uint32_t count = dropped;
+    k_mutex_unlock(&queue_lock);
+    return count;
+}
+
+static void drain_work_handler(struct k_work *work) {
+    while (true) {
+        k_mutex_lock(&queue_lock, K_FOREVER);
+        struct queued_notification *oldest = find_oldest(false);
+        if (oldest) {
+            sending      = oldest->notification;
+            oldest->used = false;
+        }
+        k_mutex_unlock(&queue_lock);
+
+        if (!oldest) {
+            return;
+        }
+        // Sent without the lock, so new notifications can queue meanwhile
+        int rc = settings_rpc_send_notification(&sending);
+        zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_NOTIFICATION);
+        if (rc < 0) {
+            LOG_ERR("Failed to send notification type %d: %d",
+                    sending.which_notification_type, rc);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Report the outcome of reliable settings relays to the web UI, so a change
+ * that did not reach a peripheral does not go unnoticed.
+ */
+
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/settings_relay.h>
+
+#include "settings_rpc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_RELIABLE) && \
+    IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+static int relay_delivery_listener(const zmk_event_t *eh) {
+    const struct zmk_settings_relay_delivery *ev =
+        as_zmk_settings_relay_delivery(eh);
+    if (!ev) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    zmk_settings_Notification notification =
+        zmk_settings_Notification_init_zero;
+    notification.which_notification_type =
+        zmk_settings_Notification_relay_delivery_tag;
+    notification.notification_type.relay_delivery =
+        (zmk_settings_RelayDeliveryNotification){
+            .source    = ev->source,
+            .delivered = ev->status == 0,
+            .attempts  = ev->attempts,
+        };
+    settings_rpc_notify(&notification);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_rpc_relay_delivery, relay_delivery_listener);
+ZMK_SUBSCRIPTION(settings_rpc_relay_delivery, zmk_settings_relay_delivery);
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Latency histograms of settings RPC requests.
+ *
+ * A request is timestamped on entry to the handler. Its response is encoded
+ * by Studio after the handler returns, so the response encoder is wrapped to
+ * take the second timestamp once the response has been written out; the
+ * sizing pass Studio may run first does not count. Latencies are counted per
+ * request type in log2 buckets of microseconds.
+ *
+ * Studio handles one request at a time and encodes its response before taking
+ * the next, so the tracked request needs no locking.
+ */
+
+#include <pb_encode.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zmk/settings/core.pb.h>
+
+#include "settings_rpc.h"
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STATS)
+
+// Indexed by the tag of the request in the Request oneof, 0 if undecodable
+#define REQUEST_TYPES 16
+
+// Highest tag of the Request oneof; update when adding a request
+#define LAST_REQUEST_TAG zmk_settings_Request_get_relay_stats_tag
+
+BUILD_ASSERT(LAST_REQUEST_TAG < REQUEST_TYPES,
+             "Request types do not fit the latency statistics");
+BUILD_ASSERT(SETTINGS_RPC_STATS_BUCKETS <=
+                 ARRAY_SIZE(((zmk_settings_RequestLatency *)0)->buckets),
+             "RequestLatency.buckets is too small");
+
+struct request_latency {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[SETTINGS_RPC_STATS_BUCKETS];
+};
+
+static struct request_latency latencies[REQUEST_TYPES];
+
+// Request whose response is being encoded
+static struct {
+    bool pending;
+    uint32_t start;
+    pb_size_t request_type;
+    pb_callback_t encode_response;
+} tracked;
+
+static void record_latency(pb_size_t request_type, uint32_t cycles) {
+    struct request_latency *latency = &latencies[request_type];
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+
+    latency->count++;
+    latency->max_us = MAX(latency->max_us, us);
+    latency->buckets[zmk_settings_rpc_log2_bucket(
+        us, SETTINGS_RPC_STATS_BUCKETS)]++;
+}
+
+static bool encode_response_timed(pb_ostream_t *stream,
+                                  const pb_field_t *field, void *const *arg) {
+    bool ok = tracked.encode_response.funcs.encode(
+        stream, field, &tracked.encode_response.arg);
+
+    // Sizing streams have no callback: wait for the pass that writes
+    if (ok && tracked.pending && stream->callback) {
+        tracked.pending = false;
+        record_latency(tracked.request_type, k_cycle_get_32() - tracked.start);
+    }
+    return ok;
+}
+
+void settings_rpc_stats_track(uint32_t start, pb_size_t request_type,
+                              pb_callback_t *encode_response) {
+    if (request_type >= REQUEST_TYPES || !encode_response->funcs.encode) {
+        return;
+    }
+
+    tracked.pending         = true;
+    tracked.start           = start;
+    tracked.request_type    = request_type;
+    tracked.encode_response = *encode_response;
+
+    encode_response->funcs.encode = encode_response_timed;
+    encode_response->arg          = NULL;
+}
+
+bool settings_rpc_stats_encode_requests(pb_ostream_t *stream,
+                                        const pb_field_t *field,
+                                        void *const *arg) {
+    for (pb_size_t type = 0; type < REQUEST_TYPES; type++) {
+        const struct request_latency *latency = &latencies[type];
+        if (latency->count == 0) {
+            continue;
+        }
+
+        zmk_settings_RequestLatency msg = zmk_settings_RequestLatency_init_zero;
+        msg.request_type  = type;
+        msg.count         = latency->count;
+        msg.max_us        = latency->max_us;
+        msg.buckets_count = SETTINGS_RPC_STATS_BUCKETS;
+        memcpy(msg.buckets, latency->buckets, sizeof(latency->buckets));
+
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_submessage(stream, zmk_settings_RequestLatency_fields,
+                                  &msg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STATS)
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Generic ListSettings, GetSetting, SetSetting, BatchGet and BatchSet RPCs.
+ *
+ * Requests are dispatched by setting id through the settings registry, so
+ * a new setting only needs a ZMK_SETTING_DEFINE descriptor and no changes to
+ * the protocol or to this file.
+ */
+
+#include <pb_encode.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zmk/settings/core.pb.h>
+#include <zmk/settings_rpc/setting.h>
+
+#include "settings_rpc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+static const zmk_settings_SettingType setting_types[] = {
+    [ZMK_SETTING_TYPE_UINT32] = zmk_settings_SettingType_SETTING_TYPE_UINT32,
+    [ZMK_SETTING_TYPE_BOOL]   = zmk_settings_SettingType_SETTING_TYPE_BOOL,
+};
+
+// Stream the descriptors straight from the registry, in id order
+static bool encode_setting_descriptors(pb_ostream_t *stream,
+                                       const pb_field_t *field,
+                                       void *const *arg) {
+    for (uint16_t id = 1; id <= CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID; id++) {
+        const struct zmk_setting *setting = zmk_setting_find(id);
+        if (!setting) {
+            continue;
+        }
+
+        zmk_settings_SettingDescriptor desc =
+            zmk_settings_SettingDescriptor_init_zero;
+        desc.id        = setting->id;
+        desc.type      = setting_types[setting->type];
+        desc.min       = setting->min;
+        desc.max       = setting->max;
+        desc.persisted = setting->persist != ZMK_SETTING_PERSIST_NONE;
+        desc.relayed   = setting->relay != ZMK_SETTING_RELAY_NONE;
+        strncpy(desc.name, setting->name, sizeof(desc.name) - 1);
+
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_submessage(stream, zmk_settings_SettingDescriptor_fields,
+                                  &desc)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int settings_rpc_handle_list_settings(
+    const zmk_settings_ListSettingsRequest *req, zmk_settings_Response *resp) {
+    resp->which_response_type = zmk_settings_Response_list_settings_tag;
+    resp->response_type.list_settings.settings.funcs.encode =
+        encode_setting_descriptors;
+    return 0;
+}
+
+int settings_rpc_handle_get_setting(const zmk_settings_GetSettingRequest *req,
+                                    zmk_settings_Response *resp) {
+    uint32_t value;
+    int rc = zmk_setting_get(req->id, &value);
+    if (rc < 0) {
+        LOG_WRN("Unknown setting id %d", req->id);
+        return rc;
+    }
+
+    zmk_settings_GetSettingResponse result =
+        zmk_settings_GetSettingResponse_init_zero;
+    result.has_setting   = true;
+    result.setting.id    = req->id;
+    result.setting.value = value;
+
+    resp->which_response_type       = zmk_settings_Response_get_setting_tag;
+    resp->response_type.get_setting = result;
+    return 0;
+}
+
+int settings_rpc_handle_set_setting(const zmk_settings_SetSettingRequest *req,
+                                    zmk_settings_Response *resp) {
+    int rc = zmk_setting_set(req->setting.id, req->setting.value);
+    if (rc == -ENOENT) {
+        return rc;
+    }
+
+    // Values rejected by the bounds or the setter are reported as
+    // success = false
+    zmk_settings_SetSettingResponse result =
+        zmk_settings_SetSettingResponse_init_zero;
+    result.success = rc == 0;
+
+    resp->which_response_type       = zmk_settings_Response_set_setting_tag;
+    resp->response_type.set_setting = result;
+    return 0;
+}
+
+int settings_rpc_handle_batch_get(const zmk_settings_BatchGetRequest *req,
+                                  zmk_settings_Response *resp) {
+    if (settings_rpc_not_modified(req->if_generation, resp)) {
+        return 0;
+    }
+
+    zmk_settings_BatchGetResponse result =
+        zmk_settings_BatchGetResponse_init_zero;
+
+    for (pb_size_t i = 0; i < req->ids_count; i++) {
+        zmk_settings_Setting *setting = &result.settings[i];
+        int rc = zmk_setting_get(req->ids[i], &setting->value);
+        if (rc < 0) {
+            LOG_WRN("Unknown setting id %d", req->ids[i]);
+            return rc;
+        }
+        setting->id = req->ids[i];
+    }
+    result.settings_count = req->ids_count;
+
+    resp->which_response_type     = zmk_settings_Response_batch_get_tag;
+    resp->response_type.batch_get = result;
+    return 0;
+}
+
+int settings_rpc_handle_batch_set(const zmk_settings_BatchSetRequest *req,
+                                  zmk_settings_Response *resp) {
+    struct zmk_setting_value values[ARRAY_SIZE(req->settings)];
+    for (pb_size_t i = 0; i < req->settings_count; i++) {
+        values[i] = (struct zmk_setting_value){
+            .id    = req->settings[i].id,
+            .value = req->settings[i].value,
+        };
+    }
+
+    // All or nothing: on failure none of the settings has changed
+    zmk_settings_BatchSetResponse result =
+        zmk_settings_BatchSetResponse_init_zero;
+    result.success =
+        zmk_setting_set_batch(values, req->settings_count) == 0;
+
+    resp->which_response_type     = zmk_settings_Response_batch_set_tag;
+    resp->response_type.batch_set = result;
+    return 0;
+}
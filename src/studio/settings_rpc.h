@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/settings/core.pb.h>
+#include <zmk/settings_rpc/util.h>
+
+// Source identifier of the central in ActivitySettings messages
+#define SETTINGS_RPC_SOURCE_CENTRAL 0
+
+/**
+ * Decode a zmk_settings_Request from @p payload and handle it, as Studio calls
+ * of the zmk__settings subsystem are. @p resp is always filled in, with an
+ * ErrorResponse if the request could not be decoded or handled.
+ *
+ * @return type of the request (its tag in the Request oneof), or 0 if it
+ *         could not be decoded
+ */
+pb_size_t settings_rpc_handle_payload(const pb_byte_t *payload, size_t size,
+                                      zmk_settings_Response *resp);
+
+/**
+ * Handle a decoded request: dispatch it to its handler and stamp @p resp with
+ * the settings generation.
+ */
+void settings_rpc_dispatch(const zmk_settings_Request *req,
+                           zmk_settings_Response *resp);
+
+/**
+ * Queue a notification to the web UI, stamped with the current settings
+ * generation. It is sent from the low priority work queue, so this can be
+ * called from any listener without waiting for the transport.
+ *
+ * @return 0 if queued, -ENOBUFS if the queue is full and it was dropped
+ */
+int settings_rpc_notify(zmk_settings_Notification *notification);
+
+/** Number of notifications dropped because the queue was full. */
+uint32_t settings_rpc_notifications_dropped(void);
+
+/**
+ * Send a notification through the zmk__settings subsystem right away.
+ * Used by the notification queue.
+ */
+int settings_rpc_send_notification(
+    const zmk_settings_Notification *notification);
+
+/**
+ * Answer a conditional request with NotModifiedResponse if the settings
+ * generation equals @p if_generation.
+ *
+ * @return true if @p resp has been filled in and the request needs no
+ *         further handling
+ */
+bool settings_rpc_not_modified(uint32_t if_generation,
+                               zmk_settings_Response *resp);
+
+/**
+ * Send an ActivitySettingsNotification for a single device. @p own is set if
+ * the device has settings of its own instead of inheriting the central's.
+ */
+void settings_rpc_notify_activity_settings(uint32_t idle_ms, uint32_t sleep_ms,
+                                           bool own, uint32_t source,
+                                           uint8_t request_id);
+
+/**
+ * Request activity settings from all devices.
+ *
+ * With @p aggregate false, every device is reported by its own notification
+ * as it answers, followed by an ActivitySettingsQueryCompleteNotification.
+ * With @p aggregate true, the reports are collected and sent as one
+ * AllActivitySettingsNotification. Either way the query completes when all
+ * peripherals have answered or CONFIG_ZMK_SETTINGS_RPC_COLLECT_TIMEOUT_MS has
+ * elapsed.
+ *
+ * If a query of the same kind is already in flight, the caller joins it: no
+ * new request is sent to the peripherals and the caller gets the id of that
+ * query. Otherwise, unless @p force is set, the query is answered right away
+ * if the settings of every peripheral are cached.
+ *
+ * @param request_id set to the id echoed in the query's notifications
+ * @param joined set to true if an existing query was joined
+ * @return 0 on success, -EBUSY if too many queries are in flight
+ */
+int activity_settings_collect(bool aggregate, bool force, uint8_t *request_id,
+                              bool *joined);
+
+/**
+ * Whether a peripheral may have activity timeouts of its own: one reported
+ * them, or the settings of one are not cached.
+ */
+bool activity_settings_peripheral_may_own(void);
+
+/**
+ * Handlers of the generic setting RPCs, dispatched through the settings
+ * registry. They fill in @p resp and return 0, or return negative errno to
+ * have an ErrorResponse sent instead.
+ */
+int settings_rpc_handle_list_settings(
+    const zmk_settings_ListSettingsRequest *req, zmk_settings_Response *resp);
+int settings_rpc_handle_get_setting(const zmk_settings_GetSettingRequest *req,
+                                    zmk_settings_Response *resp);
+int settings_rpc_handle_set_setting(const zmk_settings_SetSettingRequest *req,
+                                    zmk_settings_Response *resp);
+int settings_rpc_handle_batch_get(const zmk_settings_BatchGetRequest *req,
+                                  zmk_settings_Response *resp);
+int settings_rpc_handle_batch_set(const zmk_settings_BatchSetRequest *req,
+                                  zmk_settings_Response *resp);
+int settings_rpc_handle_subscribe(const zmk_settings_SubscribeRequest *req,
+                                  zmk_settings_Response *resp);
+int settings_rpc_handle_unsubscribe(const zmk_settings_UnsubscribeRequest *req,
+                                    zmk_settings_Response *resp);
+
+/**
+ * Handler of the GetStackUsage diagnostics RPC. Answers with enabled unset
+ * when the stack usage instrumentation is not built in.
+ */
+int settings_rpc_handle_get_stack_usage(
+    const zmk_settings_GetStackUsageRequest *req, zmk_settings_Response *resp);
+
+/**
+ * Handler of the GetStats diagnostics RPC. Answers with enabled unset when
+ * the request statistics are not built in.
+ */
+int settings_rpc_handle_get_stats(const zmk_settings_GetStatsRequest *req,
+                                  zmk_settings_Response *resp);
+
+/**
+ * Handler of the GetRelayStats diagnostics RPC. Answers with enabled unset
+ * when the relay statistics are not built in.
+ */
+int settings_rpc_handle_get_relay_stats(
+    const zmk_settings_GetRelayStatsRequest *req, zmk_settings_Response *resp);
+
+// Buckets of the request latency histograms
+#define SETTINGS_RPC_STATS_BUCKETS 16
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STATS)
+
+/** Timestamp a request on entry to the settings RPC handler. */
+static inline uint32_t settings_rpc_stats_start(void) {
+    return k_cycle_get_32();
+}
+
+/**
+ * Record the latency of a request of type @p request_type that entered the
+ * handler at @p start once its response has been encoded, by wrapping the
+ * response encoder in @p encode_response.
+ */
+void settings_rpc_stats_track(uint32_t start, pb_size_t request_type,
+                              pb_callback_t *encode_response);
+
+/**
+ * Encode callback of GetStatsResponse.requests, writing a RequestLatency
+ * for every request type seen.
+ */
+bool settings_rpc_stats_encode_requests(pb_ostream_t *stream,
+                                        const pb_field_t *field,
+                                        void *const *arg);
+
+#else
+
+static inline uint32_t settings_rpc_stats_start(void) { return 0; }
+
+static inline void settings_rpc_stats_track(uint32_t start,
+                                            pb_size_t request_type,
+                                            pb_callback_t *encode_response) {}
+
+#endif  // IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_STATS)
+
+/**
+ * Push settings reported by a peripheral without being asked to subscribed
+ * clients, rate limited like changes on the central.
+ */
+void settings_rpc_push_peripheral_settings(uint32_t source, uint32_t idle_ms,
+                                           uint32_t sleep_ms);
@@ -8,13 +8,21 @@
 
 #include <pb_decode.h>
 #include <pb_encode.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 #include <zmk/activity.h>
+#include <zmk/activity_settings.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_settings_changed.h>
-#include <zmk/events/activity_settings_report.h>
+#include <zmk/events/settings_address.h>
 #include <zmk/settings/core.pb.h>
+#include <zmk/settings_rpc/custom_notification.h>
+#include <zmk/settings_rpc/setting.h>
+#include <zmk/settings_rpc/stack_usage.h>
 #include <zmk/studio/custom.h>
+
+#include "settings_rpc.h"
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 /**
@@ -39,6 +47,21 @@ ZMK_RPC_CUSTOM_SUBSYSTEM(zmk__settings, &settings_rpc_meta,
 
 ZMK_RPC_CUSTOM_SUBSYSTEM_RESPONSE_BUFFER(zmk__settings, zmk_settings_Response);
 
+// Notifier with the subsystem index cached for notification sends
+ZMK_RPC_CUSTOM_NOTIFIER_DEFINE(zmk__settings);
+
+BUILD_ASSERT(zmk_settings_Notification_size <=
+                 CONFIG_ZMK_SETTINGS_RPC_NOTIFICATION_BUFFER_SIZE,
+             "Notification buffer is too small for zmk_settings_Notification");
+
+static int settings_rpc_init(void) {
+    // Resolve the subsystem index up front, off the notification path
+    zmk_rpc_custom_notifier_resolve(&zmk__settings_notifier);
+    return 0;
+}
+
+SYS_INIT(settings_rpc_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
 static int handle_get_activity_settings(
     const zmk_settings_GetActivitySettingsRequest *req,
     zmk_settings_Response *resp);
@@ -49,26 +72,30 @@ static int handle_get_all_activity_settings(
     const zmk_settings_GetAllActivitySettingsRequest *req,
     zmk_settings_Response *resp);
 
-// Helper function to send activity settings notification
-static void send_activity_settings_notification(uint32_t idle_ms,
-                                                uint32_t sleep_ms,
-                                                uint32_t source);
-
 /**
  * Main request handler for the settings RPC subsystem.
  * Sets up the encoding callback for the response.
  */
 static bool settings_rpc_handle_request(
     const zmk_custom_CallRequest *raw_request, pb_callback_t *encode_response) {
+    uint32_t start = settings_rpc_stats_start();
     zmk_settings_Response *resp =
         ZMK_RPC_CUSTOM_SUBSYSTEM_RESPONSE_BUFFER_ALLOCATE(zmk__settings,
                                                           encode_response);
 
+    pb_size_t request_type = settings_rpc_handle_payload(
+        raw_request->payload.bytes, raw_request->payload.size, resp);
+    zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_RPC);
+    settings_rpc_stats_track(start, request_type, encode_response);
+    return true;
+}
+
+pb_size_t settings_rpc_handle_payload(const pb_byte_t *payload, size_t size,
+                                      zmk_settings_Response *resp) {
     zmk_settings_Request req = zmk_settings_Request_init_zero;
 
     // Decode the incoming request from the raw payload
-    pb_istream_t req_stream = pb_istream_from_buffer(raw_request->payload.bytes,
-                                                     raw_request->payload.size);
+    pb_istream_t req_stream = pb_istream_from_buffer(payload, size);
     if (!pb_decode(&req_stream, zmk_settings_Request_fields, &req)) {
         LOG_WRN("Failed to decode settings request: %s",
                 PB_GET_ERROR(&req_stream));
@@ -76,26 +103,73 @@ static bool settings_rpc_handle_request(
         snprintf(err.message, sizeof(err.message), "Failed to decode request");
         resp->which_response_type = zmk_settings_Response_error_tag;
         resp->response_type.error = err;
-        return true;
+        resp->generation          = zmk_settings_generation();
+        return 0;
     }
 
+    settings_rpc_dispatch(&req, resp);
+    return req.which_request_type;
+}
+
+void settings_rpc_dispatch(const zmk_settings_Request *req,
+                           zmk_settings_Response *resp) {
     int rc = 0;
-    switch (req.which_request_type) {
+    switch (req->which_request_type) {
         case zmk_settings_Request_get_activity_settings_tag:
             rc = handle_get_activity_settings(
-                &req.request_type.get_activity_settings, resp);
+                &req->request_type.get_activity_settings, resp);
             break;
         case zmk_settings_Request_set_activity_settings_tag:
             rc = handle_set_activity_settings(
-                &req.request_type.set_activity_settings, resp);
+                &req->request_type.set_activity_settings, resp);
             break;
         case zmk_settings_Request_get_all_activity_settings_tag:
             rc = handle_get_all_activity_settings(
-                &req.request_type.get_all_activity_settings, resp);
+                &req->request_type.get_all_activity_settings, resp);
+            break;
+        case zmk_settings_Request_list_settings_tag:
+            rc = settings_rpc_handle_list_settings(
+                &req->request_type.list_settings, resp);
+            break;
+        case zmk_settings_Request_get_setting_tag:
+            rc = settings_rpc_handle_get_setting(
+                &req->request_type.get_setting, resp);
+            break;
+        case zmk_settings_Request_set_setting_tag:
+            rc = settings_rpc_handle_set_setting(
+                &req->request_type.set_setting, resp);
+            break;
+        case zmk_settings_Request_batch_get_tag:
+            rc = settings_rpc_handle_batch_get(&req->request_type.batch_get,
+                                               resp);
+            break;
+        case zmk_settings_Request_batch_set_tag:
+            rc = settings_rpc_handle_batch_set(&req->request_type.batch_set,
+                                               resp);
+            break;
+        case zmk_settings_Request_subscribe_tag:
+            rc = settings_rpc_handle_subscribe(&req->request_type.subscribe,
+                                               resp);
+            break;
+        case zmk_settings_Request_unsubscribe_tag:
+            rc = settings_rpc_handle_unsubscribe(
+                &req->request_type.unsubscribe, resp);
+            break;
+        case zmk_settings_Request_get_stack_usage_tag:
+            rc = settings_rpc_handle_get_stack_usage(
+                &req->request_type.get_stack_usage, resp);
+            break;
+        case zmk_settings_Request_get_stats_tag:
+            rc = settings_rpc_handle_get_stats(&req->request_type.get_stats,
+                                               resp);
+            break;
+        case zmk_settings_Request_get_relay_stats_tag:
+            rc = settings_rpc_handle_get_relay_stats(
+                &req->request_type.get_relay_stats, resp);
             break;
         default:
             LOG_WRN("Unsupported settings request type: %d",
-                    req.which_request_type);
+                    req->which_request_type);
             rc = -1;
     }
 
@@ -105,58 +179,33 @@ static bool settings_rpc_handle_request(
         resp->which_response_type = zmk_settings_Response_error_tag;
         resp->response_type.error = err;
     }
-    return true;
+    // Stamped last, so it includes changes made by the request itself
+    resp->generation = zmk_settings_generation();
 }
 
-/**
- * Helper to encode activity settings notification payload
- */
-static bool encode_activity_settings_notification(pb_ostream_t *stream,
-                                                  const pb_field_t *field,
-                                                  void *const *arg) {
-    zmk_settings_Notification *notification = (zmk_settings_Notification *)*arg;
-    if (!pb_encode_tag_for_field(stream, field)) {
-        return false;
-    }
-
-    size_t size;
-    if (!pb_get_encoded_size(&size, zmk_settings_Notification_fields,
-                             notification)) {
-        LOG_WRN("Failed to get encoded size for notification");
-        return false;
-    }
-
-    if (!pb_encode_varint(stream, size)) {
-        return false;
-    }
-    return pb_encode(stream, zmk_settings_Notification_fields, notification);
+int settings_rpc_send_notification(
+    const zmk_settings_Notification *notification) {
+    return zmk_rpc_custom_notify(&zmk__settings_notifier,
+                                 zmk_settings_Notification_fields,
+                                 notification);
 }
 
-static int get_subsystem_index(void) {
-    size_t subsystem_count;
-    STRUCT_SECTION_COUNT(zmk_rpc_custom_subsystem, &subsystem_count);
-
-    for (size_t i = 0; i < subsystem_count; i++) {
-        struct zmk_rpc_custom_subsystem *custom_subsys;
-        STRUCT_SECTION_GET(zmk_rpc_custom_subsystem, i, &custom_subsys);
-        if (strcmp(custom_subsys->identifier, "zmk__settings") == 0) {
-            return (int)i;
-        }
+bool settings_rpc_not_modified(uint32_t if_generation,
+                               zmk_settings_Response *resp) {
+    if (if_generation == 0 || if_generation != zmk_settings_generation()) {
+        return false;
     }
-    return -1;
+    resp->which_response_type = zmk_settings_Response_not_modified_tag;
+    LOG_DBG("Settings not modified since generation %u", if_generation);
+    return true;
 }
 
 /**
  * Helper function to send activity settings notification
  */
-static void send_activity_settings_notification(uint32_t idle_ms,
-                                                uint32_t sleep_ms,
-                                                uint32_t source) {
-    int subsystem_idx = get_subsystem_index();
-    if (subsystem_idx < 0) {
-        LOG_ERR("Failed to get subsystem index");
-        return -ENOENT;
-    }
+void settings_rpc_notify_activity_settings(uint32_t idle_ms, uint32_t sleep_ms,
+                                           bool own, uint32_t source,
+                                           uint8_t request_id) {
     zmk_settings_Notification notification =
         zmk_settings_Notification_init_zero;
     notification.which_notification_type =
@@ -165,18 +214,14 @@ static void send_activity_settings_notification(uint32_t idle_ms,
     notification.notification_type.activity_settings.settings.idle_ms = idle_ms;
     notification.notification_type.activity_settings.settings.sleep_ms =
         sleep_ms;
+    notification.notification_type.activity_settings.settings.own    = own;
     notification.notification_type.activity_settings.settings.source = source;
+    notification.notification_type.activity_settings.request_id = request_id;
 
-    struct zmk_studio_custom_notification event = {
-        .subsystem_index = subsystem_idx,
-        .encode_payload =
-            {
-                .funcs = {.encode = encode_activity_settings_notification},
-                .arg   = &notification,
-            },
-    };
-
-    raise_zmk_studio_custom_notification(event);
+    if (settings_rpc_notify(&notification) < 0) {
+        LOG_ERR("Failed to send activity settings notification");
+        return;
+    }
     LOG_DBG("Sent activity settings notification: idle=%d, sleep=%d, source=%d",
             idle_ms, sleep_ms, source);
 }
@@ -189,6 +234,10 @@ static int handle_get_activity_settings(
     zmk_settings_Response *resp) {
     LOG_DBG("Received get activity settings request");
 
+    if (settings_rpc_not_modified(req->if_generation, resp)) {
+        return 0;
+    }
+
     zmk_settings_GetActivitySettingsResponse result =
         zmk_settings_GetActivitySettingsResponse_init_zero;
 
@@ -205,42 +254,54 @@ static int handle_get_activity_settings(
 }
 
 /**
- * Handle SetActivitySettings request - updates sleep/idle timeouts
- * and propagates to peripherals via events
+ * Handle SetActivitySettings request - updates sleep/idle timeouts of the
+ * central, inherited by the peripherals without their own, or of the target
+ * devices, and propagates them to peripherals via events
  */
 static int handle_set_activity_settings(
     const zmk_settings_SetActivitySettingsRequest *req,
     zmk_settings_Response *resp) {
-    LOG_DBG("Received set activity settings request: idle=%d ms, sleep=%d ms",
-            req->settings.idle_ms, req->settings.sleep_ms);
-
-    bool success = true;
-
-    // Update idle timeout
-    if (!zmk_activity_set_idle_ms(req->settings.idle_ms)) {
-        LOG_ERR("Failed to set idle timeout to %d ms", req->settings.idle_ms);
-        success = false;
+    LOG_DBG("Received set activity settings request: idle=%d ms, sleep=%d ms "
+            "for %d targets%s",
+            req->settings.idle_ms, req->settings.sleep_ms, req->targets_count,
+            req->inherit ? ", inherit" : "");
+
+    bool local   = false;
+    uint8_t dest = 0;
+    for (pb_size_t i = 0; i < req->targets_count; i++) {
+        if (req->targets[i] > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) {
+            LOG_WRN("Unknown activity settings target %d", req->targets[i]);
+            return -EINVAL;
+        }
+        if (req->targets[i] == SETTINGS_RPC_SOURCE_CENTRAL) {
+            local = true;
+        } else {
+            dest |= ZMK_SETTINGS_RELAY_DEST(req->targets[i]);
+        }
     }
 
-    // Update sleep timeout
-    if (!zmk_activity_set_sleep_ms(req->settings.sleep_ms)) {
-        LOG_ERR("Failed to set sleep timeout to %d ms", req->settings.sleep_ms);
-        success = false;
+    int rc;
+    if (req->inherit) {
+        // The central is where the settings are inherited from: no-op for it
+        rc = zmk_activity_settings_inherit_on(
+            req->targets_count == 0 ? ZMK_SETTINGS_RELAY_DEST_ALL : dest);
+    } else if (req->targets_count == 0) {
+        // Validated and applied as a pair, relayed to the peripherals once
+        // if it changes anything
+        rc = zmk_activity_set_timeouts(req->settings.idle_ms,
+                                       req->settings.sleep_ms);
+        // Only peripherals with their own timeouts have to be told to drop
+        // them
+        if (rc == 0 && activity_settings_peripheral_may_own()) {
+            rc = zmk_activity_settings_inherit_on(ZMK_SETTINGS_RELAY_DEST_ALL);
+        }
+    } else {
+        rc = zmk_activity_set_timeouts_on(req->settings.idle_ms,
+                                          req->settings.sleep_ms, local, dest);
     }
-
+    bool success = rc == 0;
     if (success) {
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
-        // Raise event to propagate to peripherals
-        struct zmk_activity_settings_changed event = {
-            .idle_ms  = req->settings.idle_ms,
-            .sleep_ms = req->settings.sleep_ms,
-            .source   = ZMK_RELAY_EVENT_SOURCE_SELF,
-        };
-        raise_zmk_activity_settings_changed(event);
-        LOG_DBG("Activity settings updated and event raised");
-#else
-        LOG_DBG("Activity settings updated (relay not enabled)");
-#endif
+        LOG_DBG("Activity settings updated");
     }
 
     zmk_settings_SetActivitySettingsResponse result =
@@ -255,33 +316,32 @@ static int handle_set_activity_settings(
 /**
  * Handle GetAllActivitySettings request - triggers devices to report settings
  * This doesn't block - it just sends a request and returns immediately.
- * Settings will be reported via notifications.
+ * Settings will be reported via notifications, either one per device or
+ * aggregated into a single notification when req->aggregate is set.
  */
 static int handle_get_all_activity_settings(
     const zmk_settings_GetAllActivitySettingsRequest *req,
     zmk_settings_Response *resp) {
     LOG_DBG("Received get all activity settings request - triggering reports");
 
-    // Send notification with central's settings immediately
-    send_activity_settings_notification(zmk_activity_get_idle_ms(),
-                                        zmk_activity_get_sleep_ms(),
-                                        0  // Central is source 0
-    );
-
-#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
-    // Request settings from peripherals
-    // Each peripheral will report via notification when it receives the request
-    struct zmk_activity_settings_request request_event = {
-        .request_id = 0,  // Not used in notification approach
-    };
-    raise_zmk_activity_settings_request(request_event);
-    LOG_DBG("Requested settings from peripherals");
-#endif
+    // Nothing changed on any half since the client's last query
+    if (settings_rpc_not_modified(req->if_generation, resp)) {
+        return 0;
+    }
+
+    uint8_t request_id;
+    bool joined;
+    if (activity_settings_collect(req->aggregate, req->force, &request_id,
+                                  &joined) != 0) {
+        return -1;
+    }
 
     // Return success - actual settings will arrive via notifications
     zmk_settings_GetAllActivitySettingsResponse result =
         zmk_settings_GetAllActivitySettingsResponse_init_zero;
     result.request_sent = true;
+    result.request_id   = request_id;
+    result.joined       = joined;
 
     resp->which_response_type =
         zmk_settings_Response_get_all_activity_settings_tag;
@@ -289,40 +349,11 @@ static int handle_get_all_activity_settings(
     return 0;
 }
 
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT) && \
+    !IS_ENABLED(CONFIG_ZMK_SETTINGS_RPC_RELAY_COMPACT)
 
 // Relay change events from central to peripherals
 ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_activity_settings_changed, as,
                                       source);
 
-// Relay request events from central to peripherals
-ZMK_RELAY_EVENT_CENTRAL_TO_PERIPHERAL(zmk_activity_settings_request, srq, );
-
-ZMK_RELAY_EVENT_HANDLE(zmk_activity_settings_report, srp, source);
-
-/**
- * Event listener to handle settings reports from peripherals
- * Send them as notifications to the web UI
- */
-static int activity_settings_report_listener(const zmk_event_t *eh) {
-    struct zmk_activity_settings_report *ev =
-        as_zmk_activity_settings_report(eh);
-    if (!ev) {
-        return ZMK_EV_EVENT_BUBBLE;
-    }
-
-    LOG_DBG("Received settings report from peripheral %d: idle=%d, sleep=%d",
-            ev->source, ev->idle_ms, ev->sleep_ms);
-
-    // Send notification to web UI
-    send_activity_settings_notification(ev->idle_ms, ev->sleep_ms, ev->source);
-
-    return ZMK_EV_EVENT_BUBBLE;
-}
-
-ZMK_LISTENER(activity_settings_report_handler,
-             activity_settings_report_listener);
-ZMK_SUBSCRIPTION(activity_settings_report_handler,
-                 zmk_activity_settings_report);
-
 #endif  // IS_ENABLED(CONFIG_ZMK_SPLIT_RELAY_EVENT)
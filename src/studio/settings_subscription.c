@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Push of settings changes to subscribed clients.
+ *
+ * Changes are collected per device: the ids of the central's settings that
+ * changed, and the latest values reported by each peripheral. A work item
+ * sends them at most once per CONFIG_ZMK_SETTINGS_RPC_PUSH_INTERVAL_MS, so a
+ * burst of changes is pushed as one notification per device with the latest
+ * values.
+ *
+ * A subscription lasts until the client unsubscribes or Studio locks, which
+ * it does when its transport disconnects and after being idle: either ends
+ * the client's session, so a client must subscribe again to keep receiving
+ * changes.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zmk/activity_settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/setting_changed.h>
+#include <zmk/settings_rpc/setting.h>
+#include <zmk/settings_rpc/stack_usage.h>
+#include <zmk/studio/core.h>
+
+#include "settings_rpc.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+struct peripheral_change {
+    bool pending;
+    uint32_t idle_ms;
+    uint32_t sleep_ms;
+};
+
+static bool subscribed;
+static ATOMIC_DEFINE(central_changed,
+                     CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID + 1);
+// Indexed by source; the central's entry is unused
+static struct peripheral_change
+    peripheral_changes[ZMK_SETTINGS_RPC_PERIPHERAL_COUNT + 1];
+static int64_t last_push;
+static K_MUTEX_DEFINE(push_lock);
+
+static void push_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(push_work, push_work_handler);
+
+static void init_changed_notification(zmk_settings_Notification *notification,
+                                      uint32_t source) {
+    zmk_settings_Notification empty = zmk_settings_Notification_init_zero;
+
+    *notification = empty;
+    notification->which_notification_type =
+        zmk_settings_Notification_settings_changed_tag;
+    notification->notification_type.settings_changed.source = source;
+}
+
+// Must be called with push_lock held
+static void push_central_changes(void) {
+    zmk_settings_Notification notification;
+    zmk_settings_SettingsChangedNotification *changed =
+        &notification.notification_type.settings_changed;
+
+    init_changed_notification(&notification, SETTINGS_RPC_SOURCE_CENTRAL);
+    for (uint32_t id = 1; id <= CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID; id++) {
+        uint32_t value;
+        if (!atomic_test_and_clear_bit(central_changed, id) ||
+            zmk_setting_get(id, &value) < 0) {
+            continue;
+        }
+
+        changed->settings[changed->settings_count++] = (zmk_settings_Setting){
+            .id    = id,
+            .value = value,
+        };
+        // Split deltas that do not fit one notification
+        if (changed->settings_count == ARRAY_SIZE(changed->settings)) {
+            settings_rpc_notify(&notification);
+            init_changed_notification(&notification,
+                                      SETTINGS_RPC_SOURCE_CENTRAL);
+        }
+    }
+    if (changed->settings_count > 0) {
+        settings_rpc_notify(&notification);
+    }
+}
+
+// Must be called with push_lock held
+static void push_peripheral_changes(void) {
+    for (uint32_t source = 1; source <= ZMK_SETTINGS_RPC_PERIPHERAL_COUNT;
+         source++) {
+        struct peripheral_change *change = &peripheral_changes[source];
+        if (!change->pending) {
+            continue;
+        }
+        change->pending = false;
+
+        zmk_settings_Notification notification;
+        zmk_settings_SettingsChangedNotification *changed =
+            &notification.notification_type.settings_changed;
+
+        init_changed_notification(&notification, source);
+        changed->settings[changed->settings_count++] = (zmk_settings_Setting){
+            .id    = ZMK_SETTING_ID_IDLE_MS,
+            .value = change->idle_ms,
+        };
+        changed->settings[changed->settings_count++] = (zmk_settings_Setting){
+            .id    = ZMK_SETTING_ID_SLEEP_MS,
+            .value = change->sleep_ms,
+        };
+        settings_rpc_notify(&notification);
+    }
+}
+
+static void push_work_handler(struct k_work *work) {
+    k_mutex_lock(&push_lock, K_FOREVER);
+    if (subscribed) {
+        last_push = k_uptime_get();
+        push_central_changes();
+        push_peripheral_changes();
+    }
+    k_mutex_unlock(&push_lock);
+}
+
+// Push right away, unless the previous push was less than an interval ago.
+// Must be called with push_lock held.
+static void schedule_push(void) {
+    int64_t next = last_push + CONFIG_ZMK_SETTINGS_RPC_PUSH_INTERVAL_MS;
+    k_work_schedule(&push_work, K_MSEC(MAX(next - k_uptime_get(), 0)));
+}
+
+void settings_rpc_push_peripheral_settings(uint32_t source, uint32_t idle_ms,
+                                           uint32_t sleep_ms) {
+    if (source == SETTINGS_RPC_SOURCE_CENTRAL ||
+        source > ZMK_SETTINGS_RPC_PERIPHERAL_COUNT) {
+        return;
+    }
+
+    k_mutex_lock(&push_lock, K_FOREVER);
+    if (subscribed) {
+        peripheral_changes[source] = (struct peripheral_change){
+            .pending  = true,
+            .idle_ms  = idle_ms,
+            .sleep_ms = sleep_ms,
+        };
+        schedule_push();
+    }
+    k_mutex_unlock(&push_lock);
+}
+
+static int setting_changed_push_listener(const zmk_event_t *eh) {
+    const struct zmk_setting_changed *ev = as_zmk_setting_changed(eh);
+    if (!ev || ev->id > CONFIG_ZMK_SETTINGS_RPC_MAX_SETTING_ID) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    zmk_settings_stack_sample(ZMK_SETTINGS_STACK_PATH_EVENT);
+
+    k_mutex_lock(&push_lock, K_FOREVER);
+    if (subscribed) {
+        atomic_set_bit(central_changed, ev->id);
+        schedule_push();
+    }
+    k_mutex_unlock(&push_lock);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_subscription, setting_changed_push_listener);
+ZMK_SUBSCRIPTION(settings_subscription, zmk_setting_changed);
+
+static void set_subscribed(bool enable) {
+    k_mutex_lock(&push_lock, K_FOREVER);
+    subscribed = enable;
+    if (!enable) {
+        // Drop changes collected for the previous subscription
+        k_work_cancel_delayable(&push_work);
+        for (size_t i = 0; i < ARRAY_SIZE(central_changed); i++) {
+            atomic_clear(&central_changed[i]);
+        }
+        memset(peripheral_changes, 0, sizeof(peripheral_changes));
+    }
+    k_mutex_unlock(&push_lock);
+    LOG_DBG("Settings change push %s", enable ? "enabled" : "disabled");
+}
+
+static int session_end_listener(const zmk_event_t *eh) {
+    const struct zmk_studio_core_lock_state_changed *ev =
+        as_zmk_studio_core_lock_state_changed(eh);
+    if (ev && ev->state == ZMK_STUDIO_CORE_LOCK_STATE_LOCKED) {
+        set_subscribed(false);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_subscription_session, session_end_listener);
+ZMK_SUBSCRIPTION(settings_subscription_session,
+                 zmk_studio_core_lock_state_changed);
+
+int settings_rpc_handle_subscribe(const zmk_settings_SubscribeRequest *req,
+                                  zmk_settings_Response *resp) {
+    set_subscribed(true);
+    resp->which_response_type = zmk_settings_Response_subscribe_tag;
+    resp->response_type.subscribe.subscribed = true;
+    return 0;
+}
+
+int settings_rpc_handle_unsubscribe(const zmk_settings_UnsubscribeRequest *req,
+                                    zmk_settings_Response *resp) {
+    set_subscribed(false);
+    resp->which_response_type = zmk_settings_Response_unsubscribe_tag;
+    resp->response_type.unsubscribe.subscribed = false;
+    return 0;
+}
@@ -41,6 +41,9 @@ class WestCommandsTests(unittest.TestCase):
         result = run_west(["zmk-test", "tests", '-m', '.'])
         self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
         self.assertIn("PASS: studio", result.stdout)
+        self.assertIn("PASS: selftest", result.stdout)
+        self.assertIn("PASS: selftest-split-central", result.stdout)
+        self.assertIn("PASS: selftest-split-peripheral", result.stdout)
 
     def test_zmk_build(self):
         artifacts_and_expected_config: dict[str, list[str | NotFound]] = {
@@ -3,7 +3,7 @@
  * Allows getting and setting sleep/idle timeout settings
  */
 
-import { useContext, useState, useEffect, useMemo } from "react";
+import { useContext, useState, useEffect, useMemo, useRef } from "react";
 import {
   ZMKCustomSubsystem,
   ZMKAppContext,
@@ -13,10 +13,36 @@ import { Request, Response, Notification } from "./proto/zmk/settings/core";
 // Custom subsystem identifier - must match firmware registration
 export const SUBSYSTEM_IDENTIFIER = "zmk__settings";
 
+// Setting ids of the activity timeouts, as in zmk/activity_settings.h
+const SETTING_ID_IDLE_MS = 1;
+const SETTING_ID_SLEEP_MS = 2;
+
 interface DeviceSettings {
   source: number;
   idleMs: number;
   sleepMs: number;
+  // Settings of its own instead of the central's
+  own: boolean;
+}
+
+// Check if all devices that inherit the central's settings report them;
+// devices with settings of their own differ on purpose
+function isInSync(devices: DeviceSettings[]): boolean {
+  const central = devices.find((s) => s.source === 0);
+  return devices.every(
+    (s) =>
+      !central ||
+      s.own ||
+      (s.idleMs === central.idleMs && s.sleepMs === central.sleepMs)
+  );
+}
+
+// Aggregated result of a settings query
+interface QueryResult {
+  requestId: number;
+  devices: DeviceSettings[];
+  timedOutSources: number[];
+  generation: number;
 }
 
 export interface ActivitySettingsProps {
@@ -38,6 +64,29 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
     []
   );
   const [showSyncWarning, setShowSyncWarning] = useState(false);
+  const [timedOutSources, setTimedOutSources] = useState<number[]>([]);
+  // Request id of the latest settings query, used to drop stale results
+  const activeRequestId = useRef<number | null>(null);
+  // Settings generation of the displayed settings (0 if unknown), used to
+  // skip queries when nothing has changed
+  const knownGeneration = useRef(0);
+  // Result that arrived before the response naming its query: answers from
+  // the central's cache are sent while the request is being handled
+  const earlyResult = useRef<QueryResult | null>(null);
+
+  const applyResult = (result: QueryResult) => {
+    const central = result.devices.find((s) => s.source === 0);
+    if (central) {
+      setIdleMs(central.idleMs);
+      setSleepMs(central.sleepMs);
+    }
+    setAllDeviceSettings(result.devices);
+    setShowSyncWarning(!isInSync(result.devices));
+    setTimedOutSources(result.timedOutSources);
+    // Only a complete report describes this generation
+    knownGeneration.current =
+      result.timedOutSources.length === 0 ? result.generation : 0;
+  };
 
   // Memoize subsystem to prevent re-rendering on every render
   const subsystem = useMemo(
@@ -57,12 +106,34 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
         if (!notification.payload) return;
         try {
           const decoded = Notification.decode(notification.payload);
-          if (decoded.activitySettings?.settings) {
+          if (decoded.allActivitySettings) {
+            // Aggregated report: the complete set of devices at once
+            const all = decoded.allActivitySettings;
+            const result: QueryResult = {
+              requestId: all.requestId,
+              devices: all.settings.map((settings) => ({
+                source: settings.source,
+                idleMs: settings.idleMs,
+                sleepMs: settings.sleepMs,
+                own: settings.own,
+              })),
+              timedOutSources: all.timedOutSources,
+              generation: decoded.generation,
+            };
+            if (all.requestId !== activeRequestId.current) {
+              // Either superseded by a newer refresh, or ahead of the
+              // response of the refresh it answers: keep it for the latter
+              earlyResult.current = result;
+              return;
+            }
+            applyResult(result);
+          } else if (decoded.activitySettings?.settings) {
             const settings = decoded.activitySettings.settings;
             const deviceSetting: DeviceSettings = {
               source: settings.source,
               idleMs: settings.idleMs,
               sleepMs: settings.sleepMs,
+              own: settings.own,
             };
 
             setAllDeviceSettings((prev) => {
@@ -76,16 +147,47 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
                 setSleepMs(settings.sleepMs);
               }
 
-              // Check if all devices are in sync
-              const inSync = updated.every(
-                (s) =>
-                  s.idleMs === updated[0].idleMs &&
-                  s.sleepMs === updated[0].sleepMs
-              );
-              setShowSyncWarning(!inSync && updated.length > 1);
+              setShowSyncWarning(!isInSync(updated));
 
               return updated;
             });
+          } else if (decoded.settingsChanged) {
+            // Pushed change: merge the changed values into the device's entry
+            const changed = decoded.settingsChanged;
+            setAllDeviceSettings((prev) => {
+              const device = prev.find((s) => s.source === changed.source);
+              if (!device) return prev; // Not shown yet; a refresh picks it up
+              const merged = { ...device };
+              for (const setting of changed.settings) {
+                if (setting.id === SETTING_ID_IDLE_MS) {
+                  merged.idleMs = setting.value;
+                } else if (setting.id === SETTING_ID_SLEEP_MS) {
+                  merged.sleepMs = setting.value;
+                }
+              }
+              if (changed.source === 0) {
+                setIdleMs(merged.idleMs);
+                setSleepMs(merged.sleepMs);
+              }
+              const updated = prev.map((s) =>
+                s.source === changed.source ? merged : s
+              );
+              setShowSyncWarning(!isInSync(updated));
+              return updated;
+            });
+            // Every change is pushed, so the displayed settings stay current
+            if (knownGeneration.current !== 0) {
+              knownGeneration.current = decoded.generation;
+            }
+          } else if (decoded.relayDelivery) {
+            // Sent with reliable relay: a peripheral missed the change
+            const delivery = decoded.relayDelivery;
+            if (!delivery.delivered) {
+              setError(
+                `Peripheral ${delivery.source} did not confirm the change ` +
+                  `after ${delivery.attempts} attempts`
+              );
+            }
           }
         } catch (err) {
           console.error("Failed to decode notification:", err);
@@ -95,8 +197,27 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
     return () => {
       unsubscribe?.();
     };
+    // eslint-disable-next-line react-hooks/exhaustive-deps
   }, [zmkApp, zmkApp?.state.connection, subsystem]);
 
+  // Ask the firmware to push settings changes instead of polling for them
+  useEffect(() => {
+    if (!zmkApp?.state.connection || !subsystem || !autoFetch) return;
+    const service = new ZMKCustomSubsystem(
+      zmkApp.state.connection,
+      subsystem.index
+    );
+    const call = (request: Request) =>
+      service
+        .callRPC(Request.encode(request).finish())
+        .catch((err) => console.error("Failed to (un)subscribe:", err));
+
+    call(Request.create({ subscribe: {} }));
+    return () => {
+      call(Request.create({ unsubscribe: {} }));
+    };
+  }, [zmkApp, zmkApp?.state.connection, subsystem, autoFetch]);
+
   // Get current settings when component mounts or subsystem becomes available
   useEffect(() => {
     if (subsystem && zmkApp?.state.connection && autoFetch) {
@@ -107,14 +228,14 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
 
   if (!zmkApp) return null;
 
-  const getCurrentSettings = async () => {
+  // With force, the peripherals are asked even if nothing seems to have
+  // changed and the central has their settings cached
+  const getCurrentSettings = async (force = false) => {
     if (!zmkApp.state.connection || !subsystem) return;
 
     setIsLoading(true);
     setError(null);
     setMessage(null);
-    setAllDeviceSettings([]); // Clear previous device settings
-    setShowSyncWarning(false);
 
     try {
       const service = new ZMKCustomSubsystem(
@@ -123,9 +244,16 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
       );
 
       // Request settings from all devices (central + peripherals)
-      // This triggers notifications from each device
+      // The firmware answers with a single aggregated notification once
+      // every device has reported or the collection window has elapsed
+      // If nothing changed since the displayed settings were collected, the
+      // firmware answers with notModified without querying the peripherals
       const request = Request.create({
-        getAllActivitySettings: {},
+        getAllActivitySettings: {
+          aggregate: true,
+          ifGeneration: force ? 0 : knownGeneration.current,
+          force,
+        },
       });
 
       const payload = Request.encode(request).finish();
@@ -134,10 +262,25 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
       if (responsePayload) {
         const resp = Response.decode(responsePayload);
 
-        if (resp.getAllActivitySettings) {
-          if (resp.getAllActivitySettings.requestSent) {
-            setMessage("Collecting settings from all devices...");
-            // Actual settings will arrive via notifications
+        if (resp.notModified) {
+          // Displayed settings are current; drop unsaved edits
+          const central = allDeviceSettings.find((s) => s.source === 0);
+          if (central) {
+            setIdleMs(central.idleMs);
+            setSleepMs(central.sleepMs);
+          }
+        } else if (resp.getAllActivitySettings) {
+          const requestId = resp.getAllActivitySettings.requestId;
+          const early = earlyResult.current;
+          activeRequestId.current = requestId;
+          earlyResult.current = null;
+          if (early?.requestId === requestId) {
+            applyResult(early);
+          } else {
+            // Actual settings will arrive via the aggregated notification
+            setAllDeviceSettings([]); // Clear previous device settings
+            setShowSyncWarning(false);
+            setTimedOutSources([]);
           }
         } else if (resp.error) {
           setError(`Error: ${resp.error.message}`);
@@ -166,7 +309,8 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
         subsystem.index
       );
 
-      // Apply central's current settings to all devices
+      // Apply central's current settings to all devices, dropping the
+      // settings of their own
       const request = Request.create({
         setActivitySettings: {
           settings: {
@@ -186,8 +330,7 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
           if (resp.setActivitySettings.success) {
             setMessage("Settings synchronized across all devices!");
             setShowSyncWarning(false);
-            // Refresh to verify sync
-            setTimeout(() => getCurrentSettings(), 500);
+            // The new values of each device arrive as pushed changes
           } else {
             setError("Failed to sync settings");
           }
@@ -205,7 +348,10 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
     }
   };
 
-  const updateSettings = async () => {
+  // Without targets, the settings are the central's, inherited by the
+  // peripherals without settings of their own. Peripherals given as targets
+  // get them as their own, or inherit the central's again with inherit.
+  const updateSettings = async (targets: number[] = [0], inherit = false) => {
     if (!zmkApp.state.connection || !subsystem) return;
 
     setIsLoading(true);
@@ -224,6 +370,8 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
             idleMs: idleMs,
             sleepMs: sleepMs,
           },
+          targets,
+          inherit,
         },
       });
 
@@ -235,7 +383,11 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
 
         if (resp.setActivitySettings) {
           if (resp.setActivitySettings.success) {
-            setMessage("Settings updated successfully!");
+            setMessage(
+              inherit
+                ? "Device now uses the central's settings!"
+                : "Settings updated successfully!"
+            );
           } else {
             setError("Failed to update settings");
           }
@@ -276,8 +428,8 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
       {showSyncWarning && (
         <div className="warning-message">
           <p>
-            ⚠️ <strong>Settings mismatch detected!</strong> Not all devices have
-            the same settings.
+            ⚠️ <strong>Settings mismatch detected!</strong> Not all devices
+            that inherit the central's settings have them.
           </p>
           <button
             className="btn btn-primary"
@@ -289,6 +441,18 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
         </div>
       )}
 
+      {timedOutSources.length > 0 && (
+        <div className="warning-message">
+          <p>
+            ⚠️ No response from{" "}
+            {timedOutSources
+              .map((source) => `Peripheral ${source}`)
+              .join(", ")}
+            . Make sure all devices are connected.
+          </p>
+        </div>
+      )}
+
       {allDeviceSettings.length > 1 && (
         <div className="device-settings-list">
           <h3>Device Settings:</h3>
@@ -301,6 +465,27 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
                     : `Peripheral ${device.source}`}
                 </strong>
                 : Idle {device.idleMs}ms, Sleep {device.sleepMs}ms
+                {device.source !== 0 && (
+                  <>
+                    {device.own ? " (own settings) " : " (inherited) "}
+                    <button
+                      className="btn btn-secondary"
+                      onClick={() => updateSettings([device.source])}
+                      disabled={isLoading}
+                    >
+                      Apply to this device
+                    </button>
+                    {device.own && (
+                      <button
+                        className="btn btn-secondary"
+                        onClick={() => updateSettings([device.source], true)}
+                        disabled={isLoading}
+                      >
+                        Use central's settings
+                      </button>
+                    )}
+                  </>
+                )}
               </li>
             ))}
           </ul>
@@ -349,14 +534,14 @@ export function ActivitySettings({ autoFetch = true }: ActivitySettingsProps) {
         <button
           className="btn btn-secondary"
           disabled={isLoading}
-          onClick={getCurrentSettings}
+          onClick={() => getCurrentSettings(true)}
         >
           {isLoading ? "⏳ Loading..." : "🔄 Refresh"}
         </button>
         <button
           className="btn btn-primary"
           disabled={isLoading}
-          onClick={updateSettings}
+          onClick={() => updateSettings()}
         >
           {isLoading ? "⏳ Updating..." : "💾 Save Settings"}
         </button>